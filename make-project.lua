@@ -1,11 +1,31 @@
 include "scripts/postbuild.lua"
 
+newoption {
+	trigger     = "entity-id-64",
+	description = "Use 64-bit entity ids carrying a 32-bit generation"
+}
+
+newoption {
+	trigger     = "max-entities",
+	value       = "COUNT",
+	description = "Size of the entity index space (default 524288)"
+}
+
 
 workspace "ecs"
 	location "build/"
 	architecture "x86_64"
 	configurations { "debug", "release" }
 
+	-- entity id configuration, shared by the library and everything linking it
+	if _OPTIONS["entity-id-64"] then
+		defines { "ECS_ENTITY_ID_64" }
+	end
+
+	if _OPTIONS["max-entities"] then
+		defines { "ECS_MAX_ENTITY_COUNT=" .. _OPTIONS["max-entities"] .. "u" }
+	end
+
 project "ecs"
 	location  "build/"
 
@@ -33,7 +53,8 @@ project "ecs"
 	files {
 		"make-project.lua",
 		"scripts/postbuild.lua",
-		"samples/make-project.lua"
+		"samples/make-project.lua",
+		"tests/make-project.lua"
 	}
 	
 	postbuild()
@@ -63,3 +84,4 @@ project "ecs"
 		symbols "On"
 
 include "samples/make-project.lua"
+include "tests/make-project.lua"
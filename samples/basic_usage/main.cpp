@@ -34,7 +34,7 @@ struct velocity_component final : ecs::abstract_component<velocity>
 struct movement_system final : ecs::system_base<movement_system, position_component, velocity_component>
 {
 public:
-	void proc(float delta_time, position_component* positions, velocity_component* velocities) override
+	void proc(float delta_time, position_component* positions, velocity_component* velocities)
 	{
 		if (!positions || !velocities)
 		{
@@ -21,6 +21,9 @@ project "sample_basic_usage"
 		"basic_usage/**.hpp"
 	}
 
+	filter "system:linux"
+		links { "pthread" }
+
 	filter "configurations:debug"
 		defines { "_DEBUG" }
 		symbols "On"
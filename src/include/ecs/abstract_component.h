@@ -2,25 +2,31 @@
 
 #include "ecs/entity_id.h"
 #include "ecs/component_value_concept.h"
+#include "ecs/storage_policy.h"
+#include "ecs/default_allocator.h"
+#include "ecs/memory_budget.h"
+#include "ecs/dense_set.h"
 
 #include <type_traits>
 #include <limits>
-#include <array>
 
 namespace ecs
 {
 
-template<component_value T>
-struct abstract_component
+template<component_value T, storage_policy_concept P = default_storage_policy>
+struct abstract_component : dense_set<typename P::index_type>
 {
+	using policy_type = P;
+	using dense_type = dense_set<typename P::index_type>;
+
 	using value_type		 = std::remove_cvref_t<T>;
 	using ref_type			 = value_type &;
 	using const_ref_type	 = value_type const &;
 	using pointer_type		 = value_type *;
 	using const_pointer_type = value_type const *;
 	
-	using size_type = uint32_t;
-	using index_type = uint32_t;
+	using typename dense_type::size_type;
+	using typename dense_type::index_type;
 
 	using difference_type = std::ptrdiff_t;
 
@@ -29,7 +35,7 @@ struct abstract_component
 	using reverse_iterator = std::reverse_iterator<iterator>;
 	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-	static constexpr size_type MAX_SIZE = static_cast<size_type>(MAX_ENTITY_COUNT);
+	static constexpr size_type MAX_SIZE = static_cast<size_type>(policy_type::MAX_SIZE);
 
 	virtual ~abstract_component() noexcept;
 
@@ -42,20 +48,56 @@ struct abstract_component
 	pointer_type set(entity_id id, const value_type& value) noexcept
 	requires std::is_nothrow_copy_constructible_v<value_type>;
 
+	size_type insert(const entity_id* ids, const_pointer_type values, size_type count) noexcept
+	requires std::is_nothrow_copy_constructible_v<value_type>;
+
+	// Gives value to the ids [first, first + count) that lack the component; ids
+	// that have it keep theirs, and ids older than the entity stored under their
+	// index are skipped. Returns how many ids of the range were covered, short
+	// only when the pool runs out of room.
+	size_type fill(entity_id first, size_type count, const value_type& value) noexcept
+	requires std::is_nothrow_copy_constructible_v<value_type>;
+
 	const_pointer_type get(entity_id id) const noexcept;
 	pointer_type get(entity_id id) noexcept;
 
+	// get() without the id range, missing page and generation tests, which are
+	// only asserted in debug builds: id must be held by the pool. It is still a
+	// paged sparse lookup, so it saves branches, not loads; loops that can walk
+	// the dense array should use begin() and get_id() instead.
+	const_pointer_type get_unvalidated(entity_id id) const noexcept;
+	pointer_type get_unvalidated(entity_id id) noexcept;
+
 	void remove(entity_id id) noexcept;
+	void clear() noexcept;
 
 	bool has(entity_id id, const_pointer_type& out) const noexcept;
 	bool has(entity_id id, pointer_type& out) noexcept;
 	bool has(entity_id id) noexcept;
 
-	inline size_type size() const noexcept { return size_; }
-	inline bool empty() const noexcept { return size_ == 0; }
+	bool reserve(size_type capacity) noexcept;
+	void shrink_to_fit() noexcept;
+
+	size_t memory_usage() const noexcept;
+
+	void set_budget(memory_budget* budget) noexcept;
+
+	bool restore_from(const abstract_component& other) noexcept
+	requires std::is_nothrow_copy_constructible_v<value_type>;
+
+	bool clone_to(abstract_component& other) const noexcept
+	requires std::is_nothrow_copy_constructible_v<value_type>;
+
+	void touch(entity_id id) noexcept;
+
+	using dense_type::size;
+	using dense_type::capacity;
+	using dense_type::empty;
+	using dense_type::budget;
+	using dense_type::get_id;
+	using dense_type::subscribe;
+	using dense_type::unsubscribe;
 
-	entity_id get_id(index_type idx) const noexcept;
-	
 	iterator begin() noexcept;
 	iterator end() noexcept;
 	const_iterator begin() const noexcept;
@@ -79,7 +121,34 @@ protected:
 	abstract_component(const abstract_component& other) noexcept = delete;
 	abstract_component& operator=(const abstract_component& other) noexcept = delete;
 
-	static constexpr size_type INVALID_INDEX = std::numeric_limits<size_type>::max();
+	using dense_type::MIN_CAPACITY;
+	using dense_type::INVALID_INDEX;
+
+	using typename dense_type::ids_allocator_t;
+	using typename dense_type::entity_to_index_t;
+
+	using dense_type::id_of_index_;
+	using dense_type::index_of_id_;
+	using dense_type::size_;
+	using dense_type::capacity_;
+	using dense_type::budget_;
+	using dense_type::ids_version_;
+	using dense_type::observers_;
+
+	using dense_type::find_;
+	using dense_type::find_stale_;
+	using dense_type::push_;
+	using dense_type::pop_;
+	using dense_type::reset_ids_;
+	using dense_type::ids_changed_;
+	using dense_type::ids_version_tag_;
+	using dense_type::copy_ids_from_;
+	using dense_type::detach_observers_;
+	using dense_type::notify_insert_;
+	using dense_type::notify_insert_tail_;
+	using dense_type::notify_erase_;
+	using dense_type::notify_assign_;
+	using dense_type::notify_reset_;
 
 	union _proxy_storage
 	{
@@ -88,19 +157,29 @@ protected:
 		~_proxy_storage() noexcept {}
 	};
 
-	using container_t = std::array<_proxy_storage, MAX_SIZE>;
-	using index_to_entity_t = std::array<entity_id, MAX_SIZE>;
-	using entity_to_index_t = std::array<index_type, MAX_ENTITY_COUNT>;
+	using container_allocator_t = default_allocator<_proxy_storage>;
 
-	container_t container_ = {};
-	index_to_entity_t id_of_index_ = {};
-	entity_to_index_t index_of_id_ = {};
+	static constexpr size_t BYTES_PER_ITEM = sizeof(_proxy_storage) + sizeof(entity_id);
 
-	size_type size_ = 0;
+	_proxy_storage* container_ = nullptr;
+
+	// Set by pools that may hold the live values outside container_ between frames
+	// (double_buffered_component); run before anything reads or moves the values,
+	// so access through a base reference sees the same data as the derived one.
+	using sync_hook_t = void (*)(const abstract_component& self) noexcept;
+	sync_hook_t sync_hook_ = nullptr;
+
+	void sync_values_() const noexcept;
 
 	static bool index_is_valid_(index_type idx) noexcept;
 	static bool entity_id_is_valid_(entity_id id) noexcept;
 
+	size_type next_capacity_(size_type required) const noexcept;
+
+	bool prepare_insert_(entity_id id) noexcept;
+	bool grow_(size_type required) noexcept;
+	bool reallocate_(size_type capacity) noexcept;
+
 	const_pointer_type get_(index_type idx) const noexcept;
 	pointer_type get_(index_type idx) noexcept;
 };
@@ -3,100 +3,204 @@
 #include "ecs/abstract_component.h"
 
 #include <algorithm>
+#include <cassert>
+#include <cstring>
 #include <memory>
+#include <utility>
 
 namespace ecs
 {
 
-template<component_value T>
-inline abstract_component<T>::abstract_component() noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::abstract_component() noexcept
 {
-	std::ranges::fill(id_of_index_, INVALID_ENTITY_ID);
-	std::ranges::fill(index_of_id_, INVALID_INDEX);
 }
 
-template<component_value T>
-inline abstract_component<T>::~abstract_component() noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::~abstract_component() noexcept
 {
-	std::destroy_n(get_(0), size_);
+	detach_observers_();
+
+	if (container_)
+	{
+		std::destroy_n(get_(0), size_);
+		container_allocator_t{}.deallocate(container_, capacity_);
+	}
+
+	if (budget_)
+	{
+		budget_->release(memory_usage());
+	}
 }
 
-template<component_value T>
-inline abstract_component<T>::pointer_type abstract_component<T>::set(entity_id id, value_type&& value) noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::pointer_type abstract_component<T, P>::set(entity_id id, value_type&& value) noexcept
 {
+	sync_values_();
+
 	if (!entity_id_is_valid_(id))
 	{
 		return nullptr;
 	}
 
-	index_type idx = index_of_id_[id];
+	index_type idx = find_(id);
 	pointer_type ptr = nullptr;
 
 	if (!index_is_valid_(idx))
 	{
-		if (size_ >= MAX_SIZE)
+		if (!prepare_insert_(id))
 		{
 			return nullptr;
 		}
 
-		idx = size_++;
-		ptr = std::construct_at(get_(idx), std::move(value));
+		ptr = std::construct_at(get_(size_), std::move(value));
+		push_(id);
 
-		index_of_id_[id] = idx;
-		id_of_index_[idx] = id;
+		notify_insert_(id);
 	}
 	else
 	{
 		container_[idx].data = std::move(value);
 		ptr = get_(idx);
+
+		notify_assign_(id);
 	}
 
 	return ptr;
 }
 
-template<component_value  T>
-inline abstract_component<T>::pointer_type abstract_component<T>::set(entity_id id, const value_type& value) noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::pointer_type abstract_component<T, P>::set(entity_id id, const value_type& value) noexcept
 requires std::is_nothrow_copy_constructible_v<value_type>
 {
+	sync_values_();
+
 	if (!entity_id_is_valid_(id))
 	{
 		return nullptr;
 	}
 
-	index_type idx = index_of_id_[id];
+	index_type idx = find_(id);
 	pointer_type ptr = nullptr;
 
 	if (!index_is_valid_(idx))
 	{
-		if (size_ >= MAX_SIZE)
+		if (!prepare_insert_(id))
 		{
 			return nullptr;
 		}
 
-		idx = size_++;
-		ptr = std::construct_at(get_(idx), value);
+		ptr = std::construct_at(get_(size_), value);
+		push_(id);
 
-		index_of_id_[id] = idx;
-		id_of_index_[idx] = id;
+		notify_insert_(id);
 	}
 	else
 	{
 		container_[idx].data = value;
 		ptr = get_(idx);
+
+		notify_assign_(id);
 	}
 
 	return ptr;
 }
 
-template<component_value T>
-inline abstract_component<T>::const_pointer_type abstract_component<T>::get(entity_id id) const noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::size_type abstract_component<T, P>::insert(const entity_id* ids, const_pointer_type values, size_type count) noexcept
+requires std::is_nothrow_copy_constructible_v<value_type>
+{
+	sync_values_();
+
+	uint64_t required = std::min<uint64_t>(uint64_t{ size_ } + count, MAX_SIZE);
+
+	if (required > capacity_)
+	{
+		reallocate_(next_capacity_(static_cast<size_type>(required)));
+	}
+
+	size_type inserted = 0;
+
+	for (size_type idx = 0; idx < count; ++idx)
+	{
+		inserted += set(ids[idx], values[idx]) ? 1 : 0;
+	}
+
+	return inserted;
+}
+
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::size_type abstract_component<T, P>::fill(entity_id first, size_type count, const value_type& value) noexcept
+requires std::is_nothrow_copy_constructible_v<value_type>
+{
+	sync_values_();
+
+	if (!entity_id_is_valid_(first))
+	{
+		return 0;
+	}
+
+	count = static_cast<size_type>(std::min<uint64_t>(count, uint64_t{ MAX_ENTITY_COUNT } - entity_index(first)));
+
+	uint64_t required = std::min<uint64_t>(uint64_t{ size_ } + count, MAX_SIZE);
+
+	if (required > capacity_)
+	{
+		reallocate_(next_capacity_(static_cast<size_type>(required)));
+	}
+
+	// Dead generations still holding one of the indices go first, so the appends
+	// below only grow the dense tail and can be announced in one pass.
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		for (size_type offset = 0; offset < count && !empty(); ++offset)
+		{
+			index_type stale;
+
+			if (find_stale_(first + offset, stale) && index_is_valid_(stale))
+			{
+				remove(id_of_index_[stale]);
+			}
+		}
+	}
+
+	size_type tail = size_;
+	size_type filled = 0;
+
+	for (; filled < count; ++filled)
+	{
+		entity_id id = first + filled;
+
+		if (index_is_valid_(index_of_id_.find(id)))
+		{
+			continue;
+		}
+
+		if (size_ >= MAX_SIZE || (size_ == capacity_ && !grow_(size_ + 1)) || !index_of_id_.acquire(id, budget_))
+		{
+			break;
+		}
+
+		std::construct_at(get_(size_), value);
+		push_(id);
+	}
+
+	notify_insert_tail_(tail);
+
+	return filled;
+}
+
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::const_pointer_type abstract_component<T, P>::get(entity_id id) const noexcept
 {
+	sync_values_();
+
 	if (!entity_id_is_valid_(id))
 	{
 		return nullptr;
 	}
 
-	index_type idx = index_of_id_[id];
+	index_type idx = find_(id);
 
 	if (!index_is_valid_(idx))
 	{
@@ -106,15 +210,17 @@ inline abstract_component<T>::const_pointer_type abstract_component<T>::get(enti
 	return get_(idx);
 }
 
-template<component_value T>
-inline abstract_component<T>::pointer_type abstract_component<T>::get(entity_id id) noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::pointer_type abstract_component<T, P>::get(entity_id id) noexcept
 {
+	sync_values_();
+
 	if (!entity_id_is_valid_(id))
 	{
 		return nullptr;
 	}
 
-	index_type idx = index_of_id_[id];
+	index_type idx = find_(id);
 
 	if (!index_is_valid_(idx))
 	{
@@ -124,9 +230,33 @@ inline abstract_component<T>::pointer_type abstract_component<T>::get(entity_id
 	return get_(idx);
 }
 
-template<component_value T>
-inline void abstract_component<T>::remove(entity_id id) noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::const_pointer_type abstract_component<T, P>::get_unvalidated(entity_id id) const noexcept
+{
+	sync_values_();
+
+	assert(entity_id_in_range(id));
+	assert(index_is_valid_(find_(id)));
+
+	return get_(index_of_id_.find_unchecked(id));
+}
+
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::pointer_type abstract_component<T, P>::get_unvalidated(entity_id id) noexcept
+{
+	sync_values_();
+
+	assert(entity_id_in_range(id));
+	assert(index_is_valid_(find_(id)));
+
+	return get_(index_of_id_.find_unchecked(id));
+}
+
+template<component_value T, storage_policy_concept P>
+inline void abstract_component<T, P>::remove(entity_id id) noexcept
 {
+	sync_values_();
+
 	if (empty())
 	{
 		return;
@@ -137,36 +267,47 @@ inline void abstract_component<T>::remove(entity_id id) noexcept
 		return;
 	}
 
-	index_type idx = index_of_id_[id];
+	index_type idx = find_(id);
 
 	if (!index_is_valid_(idx))
 	{
 		return;
 	}
 
-	index_type last = size_ - 1;
+	notify_erase_(id);
+
+	index_type last = static_cast<index_type>(size_ - 1);
 
 	if (idx != last)
 	{
-		entity_id move = id_of_index_[last];
-
 		*get_(idx) = std::move(*get_(last));
-
-		id_of_index_[idx] = move;
-		index_of_id_[move] = idx;
 	}
 
 	std::destroy_at(get_(last));
+	pop_(idx, id);
+}
+
+template<component_value T, storage_policy_concept P>
+inline void abstract_component<T, P>::clear() noexcept
+{
+	sync_values_();
+
+	if (empty())
+	{
+		return;
+	}
 
-	id_of_index_[last] = INVALID_ENTITY_ID;
-	index_of_id_[id] = INVALID_INDEX;
+	std::destroy_n(get_(0), size_);
+	reset_ids_();
 
-	--size_;
+	notify_reset_();
 }
 
-template<component_value T>
-inline bool abstract_component<T>::has(entity_id id, const_pointer_type& out) const noexcept
+template<component_value T, storage_policy_concept P>
+inline bool abstract_component<T, P>::has(entity_id id, const_pointer_type& out) const noexcept
 {
+	sync_values_();
+
 	if (empty())
 	{
 		out = nullptr;
@@ -179,7 +320,7 @@ inline bool abstract_component<T>::has(entity_id id, const_pointer_type& out) co
 		return false;
 	}
 
-	index_type idx = index_of_id_[id];
+	index_type idx = find_(id);
 
 	if (!index_is_valid_(idx))
 	{
@@ -191,9 +332,11 @@ inline bool abstract_component<T>::has(entity_id id, const_pointer_type& out) co
 	return true;
 }
 
-template<component_value T>
-inline bool abstract_component<T>::has(entity_id id, pointer_type& out) noexcept
+template<component_value T, storage_policy_concept P>
+inline bool abstract_component<T, P>::has(entity_id id, pointer_type& out) noexcept
 {
+	sync_values_();
+
 	if (empty())
 	{
 		out = nullptr;
@@ -206,7 +349,7 @@ inline bool abstract_component<T>::has(entity_id id, pointer_type& out) noexcept
 		return false;
 	}
 
-	index_type idx = index_of_id_[id];
+	index_type idx = find_(id);
 
 	if (!index_is_valid_(idx))
 	{
@@ -218,8 +361,8 @@ inline bool abstract_component<T>::has(entity_id id, pointer_type& out) noexcept
 	return true;
 }
 
-template<component_value T>
-inline bool abstract_component<T>::has(entity_id id) noexcept
+template<component_value T, storage_policy_concept P>
+inline bool abstract_component<T, P>::has(entity_id id) noexcept
 {
 	if (empty())
 	{
@@ -231,7 +374,7 @@ inline bool abstract_component<T>::has(entity_id id) noexcept
 		return false;
 	}
 
-	index_type idx = index_of_id_[id];
+	index_type idx = find_(id);
 
 	if (!index_is_valid_(idx))
 	{
@@ -241,144 +384,375 @@ inline bool abstract_component<T>::has(entity_id id) noexcept
 	return true;
 }
 
-template<component_value T>
-inline entity_id abstract_component<T>::get_id(index_type idx) const noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::iterator abstract_component<T, P>::begin() noexcept
 {
-	if (!index_is_valid_(idx))
+	sync_values_();
+
+	if (!container_)
 	{
-		return INVALID_ENTITY_ID;
+		return nullptr;
 	}
 
-	return id_of_index_[idx];
-}
-
-template<component_value T>
-inline abstract_component<T>::iterator abstract_component<T>::begin() noexcept
-{
 	return get_(0);
 }
 
-template<component_value T>
-inline abstract_component<T>::iterator abstract_component<T>::end() noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::iterator abstract_component<T, P>::end() noexcept
 {
-	return get_(0) + size_;
+	return begin() + size_;
 }
 
-template<component_value T>
-inline abstract_component<T>::const_iterator abstract_component<T>::begin() const noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::const_iterator abstract_component<T, P>::begin() const noexcept
 {
 	return cbegin();
 }
 
-template<component_value T>
-inline abstract_component<T>::const_iterator abstract_component<T>::end() const noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::const_iterator abstract_component<T, P>::end() const noexcept
 {
 	return cend();
 }
 
-template<component_value T>
-inline abstract_component<T>::const_iterator abstract_component<T>::cbegin() const noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::const_iterator abstract_component<T, P>::cbegin() const noexcept
 {
+	sync_values_();
+
+	if (!container_)
+	{
+		return nullptr;
+	}
+
 	return get_(0);
 }
 
-template<component_value T>
-inline abstract_component<T>::const_iterator abstract_component<T>::cend() const noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::const_iterator abstract_component<T, P>::cend() const noexcept
 {
-	return get_(0) + size_;
+	return cbegin() + size_;
 }
 
-template<component_value T>
-inline abstract_component<T>::reverse_iterator abstract_component<T>::rbegin() noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::reverse_iterator abstract_component<T, P>::rbegin() noexcept
 {
 	return reverse_iterator(end());
 }
 
-template<component_value T>
-inline abstract_component<T>::reverse_iterator abstract_component<T>::rend() noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::reverse_iterator abstract_component<T, P>::rend() noexcept
 {
 	return reverse_iterator(begin());
 }
 
-template<component_value T>
-inline abstract_component<T>::const_reverse_iterator abstract_component<T>::rbegin() const noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::const_reverse_iterator abstract_component<T, P>::rbegin() const noexcept
 {
 	return crbegin();
 }
 
-template<component_value T>
-inline abstract_component<T>::const_reverse_iterator abstract_component<T>::rend() const noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::const_reverse_iterator abstract_component<T, P>::rend() const noexcept
 {
 	return crend();
 }
 
-template<component_value T>
-inline abstract_component<T>::const_reverse_iterator abstract_component<T>::crbegin() const noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::const_reverse_iterator abstract_component<T, P>::crbegin() const noexcept
 {
 	return reverse_iterator(cend());
 }
 
-template<component_value T>
-inline abstract_component<T>::const_reverse_iterator abstract_component<T>::crend() const noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::const_reverse_iterator abstract_component<T, P>::crend() const noexcept
 {
 	return reverse_iterator(cbegin());
 }
 
-template<component_value T>
-inline bool abstract_component<T>::index_is_valid_(index_type idx) noexcept
+template<component_value T, storage_policy_concept P>
+inline bool abstract_component<T, P>::reserve(size_type capacity) noexcept
+{
+	if (capacity <= capacity_)
+	{
+		return true;
+	}
+
+	if (capacity > MAX_SIZE)
+	{
+		return false;
+	}
+
+	return reallocate_(capacity);
+}
+
+template<component_value T, storage_policy_concept P>
+inline void abstract_component<T, P>::shrink_to_fit() noexcept
+{
+	size_t released = index_of_id_.shrink_to_fit();
+
+	if (budget_)
+	{
+		budget_->release(released);
+	}
+
+	if (size_ < capacity_)
+	{
+		reallocate_(size_);
+	}
+}
+
+template<component_value T, storage_policy_concept P>
+inline size_t abstract_component<T, P>::memory_usage() const noexcept
+{
+	return BYTES_PER_ITEM * capacity_ + index_of_id_.memory_usage();
+}
+
+template<component_value T, storage_policy_concept P>
+inline void abstract_component<T, P>::set_budget(memory_budget* budget) noexcept
+{
+	if (budget_ == budget)
+	{
+		return;
+	}
+
+	if (budget_)
+	{
+		budget_->release(memory_usage());
+	}
+
+	budget_ = budget;
+
+	if (budget_)
+	{
+		budget_->charge(memory_usage());
+	}
+}
+
+template<component_value T, storage_policy_concept P>
+inline bool abstract_component<T, P>::restore_from(const abstract_component& other) noexcept
+requires std::is_nothrow_copy_constructible_v<value_type>
+{
+	if (this == &other)
+	{
+		return true;
+	}
+
+	sync_values_();
+	other.sync_values_();
+
+	if (other.size_ > capacity_ && !reallocate_(next_capacity_(other.size_)))
+	{
+		return false;
+	}
+
+	std::destroy_n(begin(), size_);
+	size_ = 0;
+
+	if (!copy_ids_from_(other))
+	{
+		notify_reset_();
+		return false;
+	}
+
+	if (other.size_ > 0)
+	{
+		if constexpr (std::is_trivially_copyable_v<value_type>)
+		{
+			std::memcpy(static_cast<void*>(container_), other.container_, sizeof(_proxy_storage) * other.size_);
+		}
+		else
+		{
+			std::uninitialized_copy_n(other.get_(0), other.size_, get_(0));
+		}
+	}
+
+	size_ = other.size_;
+
+	notify_reset_();
+
+	return true;
+}
+
+template<component_value T, storage_policy_concept P>
+inline bool abstract_component<T, P>::clone_to(abstract_component& other) const noexcept
+requires std::is_nothrow_copy_constructible_v<value_type>
+{
+	return other.restore_from(*this);
+}
+
+template<component_value T, storage_policy_concept P>
+inline void abstract_component<T, P>::touch(entity_id id) noexcept
+{
+	if (!entity_id_is_valid_(id) || !index_is_valid_(find_(id)))
+	{
+		return;
+	}
+
+	notify_assign_(id);
+}
+
+template<component_value T, storage_policy_concept P>
+inline void abstract_component<T, P>::sync_values_() const noexcept
+{
+	if (sync_hook_)
+	{
+		sync_hook_(*this);
+	}
+}
+
+template<component_value T, storage_policy_concept P>
+inline bool abstract_component<T, P>::index_is_valid_(index_type idx) noexcept
 {
 	return idx != INVALID_INDEX && idx < MAX_SIZE;
 }
 
-template<component_value T>
-inline bool abstract_component<T>::entity_id_is_valid_(entity_id id) noexcept
+template<component_value T, storage_policy_concept P>
+inline bool abstract_component<T, P>::entity_id_is_valid_(entity_id id) noexcept
+{
+	if constexpr (policy_type::CHECKED)
+	{
+		return entity_id_in_range(id);
+	}
+	else
+	{
+		assert(entity_id_in_range(id));
+		return true;
+	}
+}
+
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::size_type abstract_component<T, P>::next_capacity_(size_type required) const noexcept
 {
-	return id != INVALID_ENTITY_ID && id < MAX_ENTITY_COUNT;
+	return dense_type::next_capacity_(required, MAX_SIZE);
 }
 
-template<component_value T>
-inline abstract_component<T>::const_pointer_type abstract_component<T>::get_(index_type idx) const noexcept
+template<component_value T, storage_policy_concept P>
+inline bool abstract_component<T, P>::prepare_insert_(entity_id id) noexcept
+{
+	index_type stale;
+
+	if (!find_stale_(id, stale))
+	{
+		return false;
+	}
+
+	if (index_is_valid_(stale))
+	{
+		remove(id_of_index_[stale]);
+	}
+
+	if (size_ >= MAX_SIZE)
+	{
+		return false;
+	}
+
+	if (size_ == capacity_ && !grow_(size_ + 1))
+	{
+		return false;
+	}
+
+	return index_of_id_.acquire(id, budget_);
+}
+
+template<component_value T, storage_policy_concept P>
+inline bool abstract_component<T, P>::grow_(size_type required) noexcept
+{
+	if (reallocate_(next_capacity_(required)))
+	{
+		return true;
+	}
+
+	// Doubling did not fit the budget: fall back to the smallest step that still
+	// makes room, so a tight budget slows growth down before refusing it.
+	size_type step = std::max(MIN_CAPACITY, capacity_ / 8);
+	size_type capacity = std::max(required, std::min(capacity_ + step, MAX_SIZE));
+
+	return reallocate_(capacity);
+}
+
+template<component_value T, storage_policy_concept P>
+inline bool abstract_component<T, P>::reallocate_(size_type capacity) noexcept
+{
+	sync_values_();
+
+	return dense_type::reallocate_(capacity, sizeof(_proxy_storage), [this](size_type capacity) noexcept
+	{
+		_proxy_storage* container = capacity > 0 ? container_allocator_t{}.allocate(capacity) : nullptr;
+
+		if (capacity > 0 && !container)
+		{
+			return false;
+		}
+
+		if (size_ > 0)
+		{
+			if constexpr (std::is_trivially_copyable_v<value_type>)
+			{
+				std::memcpy(static_cast<void*>(container), container_, sizeof(_proxy_storage) * size_);
+			}
+			else
+			{
+				std::uninitialized_move_n(get_(0), size_, std::addressof(container[0].data));
+				std::destroy_n(get_(0), size_);
+			}
+		}
+
+		if (container_)
+		{
+			container_allocator_t{}.deallocate(container_, capacity_);
+		}
+
+		container_ = container;
+		return true;
+	});
+}
+
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::const_pointer_type abstract_component<T, P>::get_(index_type idx) const noexcept
 {
 	return std::addressof(container_[idx].data);
 }
 
-template<component_value T>
-inline abstract_component<T>::pointer_type abstract_component<T>::get_(index_type idx) noexcept
+template<component_value T, storage_policy_concept P>
+inline abstract_component<T, P>::pointer_type abstract_component<T, P>::get_(index_type idx) noexcept
 {
 	return std::addressof(container_[idx].data);
 }
 
-template<component_value T>
+template<component_value T, storage_policy_concept P>
 template<typename... arg_t>
-inline abstract_component<T>::pointer_type abstract_component<T>::emplace(entity_id id, arg_t&&... arg) noexcept
+inline abstract_component<T, P>::pointer_type abstract_component<T, P>::emplace(entity_id id, arg_t&&... arg) noexcept
 requires std::is_nothrow_constructible_v<value_type, arg_t...>
 {
+	sync_values_();
+
 	if (!entity_id_is_valid_(id))
 	{
 		return nullptr;
 	}
 
-	index_type idx = index_of_id_[id];
+	index_type idx = find_(id);
 	pointer_type ptr = nullptr;
 
 	if (index_is_valid_(idx))
 	{
 		container_[idx].data = value_type(std::forward<arg_t>(arg)...);
 		ptr = get_(idx);
+
+		notify_assign_(id);
 	}
 	else
 	{
-		if (size_ >= MAX_SIZE)
+		if (!prepare_insert_(id))
 		{
 			return nullptr;
 		}
 
-		idx = size_++;
-
-		ptr = std::construct_at(get_(idx), std::forward<arg_t>(arg)...);
+		ptr = std::construct_at(get_(size_), std::forward<arg_t>(arg)...);
+		push_(id);
 
-		index_of_id_[id] = idx;
-		id_of_index_[idx] = id;
+		notify_insert_(id);
 	}
 
 	return ptr;
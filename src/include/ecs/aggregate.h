@@ -0,0 +1,117 @@
+#pragma once
+
+#include "ecs/component_concept.h"
+#include "ecs/dynamic_array.h"
+#include "ecs/sparse_index.h"
+
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+
+namespace ecs
+{
+
+template<typename F, typename T>
+concept aggregate_field_fn = std::is_nothrow_default_constructible_v<F> && requires (const F f, const typename T::value_type& value)
+{
+	{ f(value) } noexcept;
+	requires std::is_arithmetic_v<std::decay_t<decltype(f(value))>>;
+};
+
+// Count, sum, min and max of one field over every entity of a pool that also has
+// all filter_t components. Kept up to date through pool notifications: the field
+// values are mirrored densely, the sum is adjusted on every change and min/max
+// come from a segment tree, so removals never force a rescan and every read is
+// O(1). If the tree could not be allocated, min/max fall back to a linear scan
+// until it can. Writes made through get() are only seen after the pool's touch(id).
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+struct aggregate
+{
+	using field_type = std::decay_t<std::invoke_result_t<const F&, const typename T::value_type&>>;
+	using sum_type = std::conditional_t<std::is_floating_point_v<field_type>, double,
+					 std::conditional_t<std::is_signed_v<field_type>, int64_t, uint64_t>>;
+	using size_type = uint32_t;
+
+	aggregate() noexcept = default;
+	explicit aggregate(T* pool, filter_t*... filters) noexcept;
+	~aggregate() noexcept;
+
+	aggregate(const aggregate&) = delete;
+	aggregate& operator=(const aggregate&) = delete;
+
+	bool bind(T* pool, filter_t*... filters) noexcept;
+	void unbind() noexcept;
+
+	bool rebuild() noexcept;
+	void recompute() noexcept;
+	bool verify() const noexcept;
+
+	inline bool valid() const noexcept { return pool_ != nullptr; }
+	inline size_type count() const noexcept { return static_cast<size_type>(values_.size()); }
+	inline bool empty() const noexcept { return values_.empty(); }
+
+	inline sum_type sum() const noexcept { return sum_; }
+	field_type min() const noexcept;
+	field_type max() const noexcept;
+	inline double mean() const noexcept { return empty() ? 0.0 : static_cast<double>(sum_) / static_cast<double>(values_.size()); }
+
+private:
+
+	using index_type = uint32_t;
+	using position_index_t = sparse_index<index_type>;
+
+	struct _extent
+	{
+		field_type min;
+		field_type max;
+	};
+
+	struct _totals
+	{
+		sum_type sum;
+		double magnitude;
+		field_type min;
+		field_type max;
+	};
+
+	static constexpr _extent EMPTY_EXTENT = { std::numeric_limits<field_type>::max(), std::numeric_limits<field_type>::lowest() };
+	static constexpr size_t MIN_LEAVES = 64;
+	static constexpr size_t SCAN_LANES = 8;
+
+	T* pool_ = nullptr;
+	std::tuple<filter_t*...> filters_ = {};
+
+	dynamic_array<field_type> values_;
+	dynamic_array<entity_id> ids_;
+	position_index_t position_of_;
+
+	dynamic_array<_extent> tree_;
+	size_t leaves_ = 0;
+	sum_type sum_ = 0;
+
+	bool matches_(entity_id id) const noexcept;
+	field_type field_of_(entity_id id) const noexcept;
+
+	bool append_(entity_id id) noexcept;
+	void erase_(entity_id id) noexcept;
+	void assign_(entity_id id) noexcept;
+	void clear_() noexcept;
+
+	bool build_tree_(size_t capacity) noexcept;
+	void update_leaf_(size_t position, _extent extent) noexcept;
+
+	_totals scan_() const noexcept;
+
+	static void on_insert_(void* context, entity_id id) noexcept;
+	static void on_erase_(void* context, entity_id id) noexcept;
+	static void on_assign_(void* context, entity_id id) noexcept;
+	static void on_reset_(void* context) noexcept;
+	static void on_detach_(void* context) noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/aggregate.hpp"
@@ -0,0 +1,501 @@
+#pragma once
+
+#include "ecs/aggregate.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ecs
+{
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline aggregate<T, F, filter_t...>::aggregate(T* pool, filter_t*... filters) noexcept
+{
+	bind(pool, filters...);
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline aggregate<T, F, filter_t...>::~aggregate() noexcept
+{
+	unbind();
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline bool aggregate<T, F, filter_t...>::bind(T* pool, filter_t*... filters) noexcept
+{
+	unbind();
+
+	if (pool == nullptr || ((filters == nullptr) || ...))
+	{
+		return false;
+	}
+
+	component_observer observer {};
+	observer.context = this;
+	observer.on_insert = &on_insert_;
+	observer.on_erase = &on_erase_;
+	observer.on_reset = &on_reset_;
+	observer.on_detach = &on_detach_;
+
+	// Filters only gate membership, value changes matter on the aggregated pool alone.
+	[[maybe_unused]] component_observer filter_observer = observer;
+	observer.on_assign = &on_assign_;
+
+	pool_ = pool;
+	filters_ = { filters... };
+
+	if (!pool->subscribe(observer) || !(filters->subscribe(filter_observer) && ...))
+	{
+		unbind();
+		return false;
+	}
+
+	return rebuild();
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline void aggregate<T, F, filter_t...>::unbind() noexcept
+{
+	if (pool_)
+	{
+		pool_->unsubscribe(this);
+
+		std::apply([this](filter_t*... filters)
+		{
+			(filters->unsubscribe(this), ...);
+		},
+		filters_);
+	}
+
+	pool_ = nullptr;
+	filters_ = {};
+
+	clear_();
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline bool aggregate<T, F, filter_t...>::rebuild() noexcept
+{
+	clear_();
+
+	if (!pool_)
+	{
+		return false;
+	}
+
+	bool complete = values_.reserve(pool_->size()) && ids_.reserve(pool_->size());
+
+	for (size_type idx = 0; idx < pool_->size(); ++idx)
+	{
+		entity_id id = pool_->get_id(idx);
+
+		if (!matches_(id))
+		{
+			continue;
+		}
+
+		index_type position = static_cast<index_type>(values_.size());
+
+		if (!position_of_.acquire(id, nullptr) || !values_.emplace_back(field_of_(id)))
+		{
+			complete = false;
+			continue;
+		}
+
+		if (!ids_.emplace_back(id))
+		{
+			values_.pop_back();
+			complete = false;
+			continue;
+		}
+
+		position_of_.set(id, position);
+	}
+
+	recompute();
+	return complete && !tree_.empty();
+}
+
+// Full pass over the mirrored field values, used to refresh the incremental
+// results and to check them. The lanes are independent so the loop vectorizes.
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline void aggregate<T, F, filter_t...>::recompute() noexcept
+{
+	sum_ = scan_().sum;
+	build_tree_(values_.size());
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline bool aggregate<T, F, filter_t...>::verify() const noexcept
+{
+	if (!pool_)
+	{
+		return values_.empty();
+	}
+
+	for (size_t position = 0; position < ids_.size(); ++position)
+	{
+		entity_id id = ids_[position];
+
+		if (!matches_(id) || field_of_(id) != values_[position])
+		{
+			return false;
+		}
+	}
+
+	_totals totals = scan_();
+
+	if constexpr (std::is_floating_point_v<field_type>)
+	{
+		double tolerance = std::numeric_limits<double>::epsilon() * static_cast<double>(values_.size() + 1) * totals.magnitude;
+
+		if (std::abs(static_cast<double>(sum_) - static_cast<double>(totals.sum)) > tolerance)
+		{
+			return false;
+		}
+	}
+	else if (sum_ != totals.sum)
+	{
+		return false;
+	}
+
+	return empty() || (min() == totals.min && max() == totals.max);
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline aggregate<T, F, filter_t...>::field_type aggregate<T, F, filter_t...>::min() const noexcept
+{
+	if (empty())
+	{
+		return field_type{};
+	}
+
+	return tree_.empty() ? scan_().min : tree_[1].min;
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline aggregate<T, F, filter_t...>::field_type aggregate<T, F, filter_t...>::max() const noexcept
+{
+	if (empty())
+	{
+		return field_type{};
+	}
+
+	return tree_.empty() ? scan_().max : tree_[1].max;
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline bool aggregate<T, F, filter_t...>::matches_(entity_id id) const noexcept
+{
+	if (!pool_->has(id))
+	{
+		return false;
+	}
+
+	return std::apply([id](filter_t*... filters)
+	{
+		return (filters->has(id) && ...);
+	},
+	filters_);
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline aggregate<T, F, filter_t...>::field_type aggregate<T, F, filter_t...>::field_of_(entity_id id) const noexcept
+{
+	return F{}(*pool_->get(id));
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline bool aggregate<T, F, filter_t...>::append_(entity_id id) noexcept
+{
+	if (position_of_.find(id) != position_index_t::INVALID_INDEX)
+	{
+		return true;
+	}
+
+	index_type position = static_cast<index_type>(values_.size());
+	field_type value = field_of_(id);
+
+	if (!position_of_.acquire(id, nullptr) || !values_.emplace_back(value))
+	{
+		return false;
+	}
+
+	if (!ids_.emplace_back(id))
+	{
+		values_.pop_back();
+		return false;
+	}
+
+	position_of_.set(id, position);
+	sum_ += static_cast<sum_type>(value);
+
+	if (position < leaves_)
+	{
+		update_leaf_(position, { value, value });
+		return true;
+	}
+
+	return build_tree_(values_.size());
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline void aggregate<T, F, filter_t...>::erase_(entity_id id) noexcept
+{
+	index_type position = position_of_.find(id);
+
+	// The position index is keyed by the index part only; another generation of
+	// the same index is not ours to erase.
+	if (position == position_index_t::INVALID_INDEX || ids_[position] != id)
+	{
+		return;
+	}
+
+	index_type last = static_cast<index_type>(values_.size() - 1);
+
+	sum_ -= static_cast<sum_type>(values_[position]);
+
+	if (position != last)
+	{
+		field_type moved = values_[last];
+
+		values_[position] = moved;
+		ids_[position] = ids_[last];
+		position_of_.set(ids_[last], position);
+
+		update_leaf_(position, { moved, moved });
+	}
+
+	values_.pop_back();
+	ids_.pop_back();
+	position_of_.reset(id);
+
+	update_leaf_(last, EMPTY_EXTENT);
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline void aggregate<T, F, filter_t...>::assign_(entity_id id) noexcept
+{
+	index_type position = position_of_.find(id);
+
+	if (position == position_index_t::INVALID_INDEX || ids_[position] != id)
+	{
+		return;
+	}
+
+	field_type value = field_of_(id);
+	field_type previous = values_[position];
+
+	if (value == previous)
+	{
+		return;
+	}
+
+	values_[position] = value;
+
+	sum_ -= static_cast<sum_type>(previous);
+	sum_ += static_cast<sum_type>(value);
+
+	update_leaf_(position, { value, value });
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline void aggregate<T, F, filter_t...>::clear_() noexcept
+{
+	for (entity_id id : ids_)
+	{
+		position_of_.reset(id);
+	}
+
+	values_.clear();
+	ids_.clear();
+	tree_.clear();
+
+	leaves_ = 0;
+	sum_ = 0;
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline bool aggregate<T, F, filter_t...>::build_tree_(size_t capacity) noexcept
+{
+	size_t leaves = std::max(leaves_, MIN_LEAVES);
+
+	while (leaves < capacity)
+	{
+		leaves *= 2;
+	}
+
+	if (!tree_.resize(leaves * 2))
+	{
+		tree_.clear();
+		leaves_ = 0;
+		return false;
+	}
+
+	leaves_ = leaves;
+
+	_extent* nodes = tree_.data();
+
+	for (size_t position = 0; position < leaves; ++position)
+	{
+		nodes[leaves + position] = position < values_.size() ? _extent{ values_[position], values_[position] } : EMPTY_EXTENT;
+	}
+
+	for (size_t node = leaves - 1; node > 0; --node)
+	{
+		const _extent& left = nodes[node * 2];
+		const _extent& right = nodes[node * 2 + 1];
+
+		nodes[node] = { std::min(left.min, right.min), std::max(left.max, right.max) };
+	}
+
+	return true;
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline void aggregate<T, F, filter_t...>::update_leaf_(size_t position, _extent extent) noexcept
+{
+	if (position >= leaves_)
+	{
+		return;
+	}
+
+	_extent* nodes = tree_.data();
+	size_t node = leaves_ + position;
+
+	nodes[node] = extent;
+
+	for (node /= 2; node > 0; node /= 2)
+	{
+		const _extent& left = nodes[node * 2];
+		const _extent& right = nodes[node * 2 + 1];
+
+		_extent combined = { std::min(left.min, right.min), std::max(left.max, right.max) };
+
+		// Ancestors of an unchanged node are unchanged too.
+		if (combined.min == nodes[node].min && combined.max == nodes[node].max)
+		{
+			break;
+		}
+
+		nodes[node] = combined;
+	}
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline aggregate<T, F, filter_t...>::_totals aggregate<T, F, filter_t...>::scan_() const noexcept
+{
+	const field_type* values = values_.data();
+	const size_t count = values_.size();
+
+	sum_type sum[SCAN_LANES] = {};
+	double magnitude[SCAN_LANES] = {};
+	field_type low[SCAN_LANES];
+	field_type high[SCAN_LANES];
+
+	for (size_t lane = 0; lane < SCAN_LANES; ++lane)
+	{
+		low[lane] = EMPTY_EXTENT.min;
+		high[lane] = EMPTY_EXTENT.max;
+	}
+
+	size_t idx = 0;
+
+	for (; idx + SCAN_LANES <= count; idx += SCAN_LANES)
+	{
+		for (size_t lane = 0; lane < SCAN_LANES; ++lane)
+		{
+			field_type value = values[idx + lane];
+
+			sum[lane] += static_cast<sum_type>(value);
+			magnitude[lane] += std::abs(static_cast<double>(value));
+			low[lane] = value < low[lane] ? value : low[lane];
+			high[lane] = value > high[lane] ? value : high[lane];
+		}
+	}
+
+	for (; idx < count; ++idx)
+	{
+		field_type value = values[idx];
+
+		sum[0] += static_cast<sum_type>(value);
+		magnitude[0] += std::abs(static_cast<double>(value));
+		low[0] = value < low[0] ? value : low[0];
+		high[0] = value > high[0] ? value : high[0];
+	}
+
+	_totals totals = { 0, 0.0, EMPTY_EXTENT.min, EMPTY_EXTENT.max };
+
+	for (size_t lane = 0; lane < SCAN_LANES; ++lane)
+	{
+		totals.sum += sum[lane];
+		totals.magnitude += magnitude[lane];
+		totals.min = std::min(totals.min, low[lane]);
+		totals.max = std::max(totals.max, high[lane]);
+	}
+
+	return totals;
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline void aggregate<T, F, filter_t...>::on_insert_(void* context, entity_id id) noexcept
+{
+	aggregate* self = static_cast<aggregate*>(context);
+
+	if (self->matches_(id))
+	{
+		self->append_(id);
+	}
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline void aggregate<T, F, filter_t...>::on_erase_(void* context, entity_id id) noexcept
+{
+	static_cast<aggregate*>(context)->erase_(id);
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline void aggregate<T, F, filter_t...>::on_assign_(void* context, entity_id id) noexcept
+{
+	static_cast<aggregate*>(context)->assign_(id);
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline void aggregate<T, F, filter_t...>::on_reset_(void* context) noexcept
+{
+	static_cast<aggregate*>(context)->rebuild();
+}
+
+template<ecs_component T, typename F, ecs_component... filter_t>
+requires aggregate_field_fn<F, T>
+inline void aggregate<T, F, filter_t...>::on_detach_(void* context) noexcept
+{
+	// Every pool is told to stop notifying, including the one being destroyed,
+	// which has already moved its observer list out.
+	static_cast<aggregate*>(context)->unbind();
+}
+
+} // namespace ecs
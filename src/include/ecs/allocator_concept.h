@@ -1,5 +1,6 @@
 ﻿#pragma once
 
+#include <cstddef>
 #include <type_traits>
 #include <concepts>
 
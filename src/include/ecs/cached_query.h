@@ -0,0 +1,71 @@
+#pragma once
+
+#include "ecs/component_concept.h"
+#include "ecs/dynamic_array.h"
+#include "ecs/sparse_index.h"
+
+#include <cstdint>
+#include <tuple>
+
+namespace ecs
+{
+
+// Persistent list of the entities that have every component_t. Kept up to date
+// through pool notifications, so iterating it is a linear walk with no filtering.
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+struct cached_query
+{
+	using size_type = uint32_t;
+	using const_iterator = const entity_id*;
+
+	cached_query() noexcept = default;
+	explicit cached_query(component_t*... pools) noexcept;
+	~cached_query() noexcept;
+
+	cached_query(const cached_query&) = delete;
+	cached_query& operator=(const cached_query&) = delete;
+
+	bool bind(component_t*... pools) noexcept;
+	void unbind() noexcept;
+
+	bool rebuild() noexcept;
+
+	template<typename fn_t>
+	void each(fn_t&& fn) noexcept;
+
+	bool contains(entity_id id) const noexcept;
+
+	inline bool valid() const noexcept { return bound_; }
+	inline size_type size() const noexcept { return static_cast<size_type>(ids_.size()); }
+	inline bool empty() const noexcept { return ids_.empty(); }
+
+	inline const_iterator begin() const noexcept { return ids_.begin(); }
+	inline const_iterator end() const noexcept { return ids_.end(); }
+
+private:
+
+	using index_type = uint32_t;
+	using position_index_t = sparse_index<index_type>;
+
+	std::tuple<component_t*...> pools_ = {};
+	bool bound_ = false;
+
+	dynamic_array<entity_id> ids_;
+	position_index_t position_of_;
+
+	bool matches_(entity_id id) const noexcept;
+
+	bool append_(entity_id id) noexcept;
+	void erase_(entity_id id) noexcept;
+	void clear_() noexcept;
+
+	static void on_insert_(void* context, entity_id id) noexcept;
+	static void on_erase_(void* context, entity_id id) noexcept;
+	static void on_reset_(void* context) noexcept;
+	static void on_detach_(void* context) noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/cached_query.hpp"
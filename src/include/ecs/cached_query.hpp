@@ -0,0 +1,259 @@
+#pragma once
+
+#include "ecs/cached_query.h"
+
+#include <algorithm>
+
+namespace ecs
+{
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline cached_query<component_t...>::cached_query(component_t*... pools) noexcept
+{
+	bind(pools...);
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline cached_query<component_t...>::~cached_query() noexcept
+{
+	unbind();
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline bool cached_query<component_t...>::bind(component_t*... pools) noexcept
+{
+	unbind();
+
+	if (((pools == nullptr) || ...))
+	{
+		return false;
+	}
+
+	component_observer observer {};
+	observer.context = this;
+	observer.on_insert = &on_insert_;
+	observer.on_erase = &on_erase_;
+	observer.on_reset = &on_reset_;
+	observer.on_detach = &on_detach_;
+
+	pools_ = { pools... };
+	bound_ = true;
+
+	if (!(pools->subscribe(observer) && ...))
+	{
+		unbind();
+		return false;
+	}
+
+	return rebuild();
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline void cached_query<component_t...>::unbind() noexcept
+{
+	if (bound_)
+	{
+		std::apply([this](component_t*... pools)
+		{
+			(pools->unsubscribe(this), ...);
+		},
+		pools_);
+	}
+
+	pools_ = {};
+	bound_ = false;
+
+	clear_();
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline bool cached_query<component_t...>::rebuild() noexcept
+{
+	clear_();
+
+	if (!bound_)
+	{
+		return false;
+	}
+
+	return std::apply([this](component_t*... pools)
+	{
+		size_t smallest = std::min({ static_cast<size_t>(pools->size())... });
+		bool scanned = false;
+		bool complete = true;
+
+		([&](auto* pool)
+		{
+			if (scanned || pool->size() != smallest)
+			{
+				return;
+			}
+
+			scanned = true;
+			complete = ids_.reserve(smallest);
+
+			for (size_type idx = 0; idx < pool->size(); ++idx)
+			{
+				entity_id id = pool->get_id(idx);
+
+				if (matches_(id))
+				{
+					complete = append_(id) && complete;
+				}
+			}
+		}(pools), ...);
+
+		return complete;
+	},
+	pools_);
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+template<typename fn_t>
+inline void cached_query<component_t...>::each(fn_t&& fn) noexcept
+{
+	if (!bound_)
+	{
+		return;
+	}
+
+	std::apply([this, &fn](component_t*... pools)
+	{
+		for (entity_id id : ids_)
+		{
+			fn(id, *pools->get(id)...);
+		}
+	},
+	pools_);
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline bool cached_query<component_t...>::contains(entity_id id) const noexcept
+{
+	if (!entity_id_in_range(id))
+	{
+		return false;
+	}
+
+	auto pos = position_of_.find(id);
+	return pos != position_index_t::INVALID_INDEX && ids_[pos] == id;
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline bool cached_query<component_t...>::matches_(entity_id id) const noexcept
+{
+	return std::apply([id](component_t*... pools)
+	{
+		return (pools->has(id) && ...);
+	},
+	pools_);
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline bool cached_query<component_t...>::append_(entity_id id) noexcept
+{
+	if (contains(id))
+	{
+		return true;
+	}
+
+	index_type position = static_cast<index_type>(ids_.size());
+
+	if (!position_of_.acquire(id, nullptr) || !ids_.emplace_back(id))
+	{
+		return false;
+	}
+
+	position_of_.set(id, position);
+	return true;
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline void cached_query<component_t...>::erase_(entity_id id) noexcept
+{
+	if (!contains(id))
+	{
+		return;
+	}
+
+	index_type position = position_of_.find(id);
+	entity_id last = ids_.back();
+
+	if (last != id)
+	{
+		ids_[position] = last;
+		position_of_.set(last, position);
+	}
+
+	ids_.pop_back();
+	position_of_.reset(id);
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline void cached_query<component_t...>::clear_() noexcept
+{
+	for (entity_id id : ids_)
+	{
+		position_of_.reset(id);
+	}
+
+	ids_.clear();
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline void cached_query<component_t...>::on_insert_(void* context, entity_id id) noexcept
+{
+	cached_query* self = static_cast<cached_query*>(context);
+
+	if (self->matches_(id))
+	{
+		self->append_(id);
+	}
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline void cached_query<component_t...>::on_erase_(void* context, entity_id id) noexcept
+{
+	static_cast<cached_query*>(context)->erase_(id);
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline void cached_query<component_t...>::on_reset_(void* context) noexcept
+{
+	static_cast<cached_query*>(context)->rebuild();
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0)
+inline void cached_query<component_t...>::on_detach_(void* context) noexcept
+{
+	cached_query* self = static_cast<cached_query*>(context);
+
+	// The detaching pool is mid-destruction, the others are still alive and must
+	// stop notifying this query.
+	std::apply([self](component_t*... pools)
+	{
+		(pools->unsubscribe(self), ...);
+	},
+	self->pools_);
+
+	self->pools_ = {};
+	self->bound_ = false;
+	self->clear_();
+}
+
+} // namespace ecs
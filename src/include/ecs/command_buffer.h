@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ecs/component_concept.h"
+#include "ecs/component_locator.h"
+#include "ecs/dynamic_array.h"
+#include "ecs/entity_id_allocator.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace ecs
+{
+
+// Structural changes recorded from any thread and applied to a world at the next
+// sync point. Like event_queue, every thread slot records into its own lane, so
+// recording takes no lock. Ids from create() are valid immediately and can be
+// referenced by later commands; their components only exist after flush().
+//
+// flush() replays lane by lane: commands of one thread keep their order, commands
+// of different threads touching the same entity have no defined order.
+struct command_buffer
+{
+	using size_type = uint32_t;
+
+	static constexpr size_type MAX_LANES = 64;
+
+	explicit command_buffer(entity_id_allocator* ids = nullptr) noexcept;
+
+	command_buffer(const command_buffer&) = delete;
+	command_buffer& operator=(const command_buffer&) = delete;
+
+	entity_id create() noexcept;
+
+	template<ecs_component T>
+	requires std::is_trivially_copyable_v<typename T::value_type>
+	bool set(entity_id id, const typename T::value_type& value) noexcept;
+
+	template<ecs_component T>
+	bool remove(entity_id id) noexcept;
+
+	// Removes the entity from every pool and returns its id to the allocator.
+	bool destroy(entity_id id) noexcept;
+
+	size_type flush(component_locator& world) noexcept;
+	void clear() noexcept;
+
+	size_type pending() const noexcept;
+
+	inline entity_id_allocator* ids() const noexcept { return ids_; }
+
+private:
+
+	using apply_fn = void (*)(component_locator&, entity_id, const void*);
+
+	enum class _op : uint32_t
+	{
+		apply,
+		destroy
+	};
+
+	struct _command
+	{
+		apply_fn apply;
+		entity_id id;
+		_op op;
+		uint32_t size;
+	};
+
+	struct alignas(64) _lane
+	{
+		dynamic_array<std::byte> stream;
+		size_type count = 0;
+	};
+
+	entity_id_allocator* ids_;
+
+	std::array<_lane, MAX_LANES> lanes_;
+	std::atomic<uint64_t> active_lanes_ = 0;
+
+	_lane overflow_;
+	std::atomic_flag overflow_lock_;
+
+	bool record_(_op op, apply_fn apply, entity_id id, const void* payload, uint32_t size) noexcept;
+	static bool append_(_lane& lane, const _command& command, const void* payload) noexcept;
+
+	size_type replay_(_lane& lane, component_locator& world) noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/command_buffer.hpp"
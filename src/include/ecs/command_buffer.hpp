@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ecs/command_buffer.h"
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+namespace ecs
+{
+
+template<ecs_component T>
+requires std::is_trivially_copyable_v<typename T::value_type>
+inline bool command_buffer::set(entity_id id, const typename T::value_type& value) noexcept
+{
+	using value_type = typename T::value_type;
+
+	apply_fn apply = [](component_locator& world, entity_id id, const void* payload)
+	{
+		T* pool = world.get<T>();
+
+		if (!pool && !(pool = world.add<T>()))
+		{
+			return;
+		}
+
+		// Payloads are packed without padding, so the value is copied out into
+		// aligned storage, which also creates it without a default constructor.
+		alignas(value_type) std::byte storage[sizeof(value_type)];
+		std::memcpy(storage, payload, sizeof(value_type));
+
+		pool->set(id, *std::launder(reinterpret_cast<const value_type*>(storage)));
+	};
+
+	return record_(_op::apply, apply, id, &value, static_cast<uint32_t>(sizeof(value_type)));
+}
+
+template<ecs_component T>
+inline bool command_buffer::remove(entity_id id) noexcept
+{
+	apply_fn apply = [](component_locator& world, entity_id id, const void*)
+	{
+		if (T* pool = world.get<T>())
+		{
+			pool->remove(id);
+		}
+	};
+
+	return record_(_op::apply, apply, id, nullptr, 0);
+}
+
+} // namespace ecs
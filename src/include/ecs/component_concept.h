@@ -11,7 +11,8 @@ template<typename T>
 concept ecs_component = requires
 {
 	typename T::value_type;
-	requires std::derived_from<T, abstract_component<typename T::value_type>>;
+	typename T::policy_type;
+	requires std::derived_from<T, abstract_component<typename T::value_type, typename T::policy_type>>;
 }
 && std::is_nothrow_default_constructible_v<T>
 && std::is_nothrow_destructible_v<T>;
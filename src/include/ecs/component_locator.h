@@ -3,10 +3,15 @@
 #include "ecs/component_concept.h"
 #include "ecs/allocator_concept.h"
 #include "ecs/default_allocator.h"
+#include "ecs/dynamic_array.h"
+#include "ecs/memory_budget.h"
+#include "ecs/cached_query.h"
+#include "ecs/runtime_component.h"
 
+#include <atomic>
 #include <cstdint>
-#include <array>
 #include <limits>
+#include <mutex>
 
 namespace ecs
 {
@@ -14,8 +19,10 @@ namespace ecs
 struct component_locator
 {
 	using size_type = uint32_t;
+	using component_index = uint32_t;
 
 	static constexpr size_type MAX_SIZE = 512;
+	static constexpr component_index INVALID_COMPONENT_INDEX = std::numeric_limits<component_index>::max();
 
 	component_locator() noexcept = default;
 	~component_locator() noexcept;
@@ -39,27 +46,116 @@ struct component_locator
 	template<ecs_component T>
 	T* get() const noexcept;
 
+	// Runtime-defined types share the index space of static types and are keyed by
+	// descriptor name. Adding a name that already has a pool replaces it.
+	runtime_component* add(const component_descriptor& descriptor) noexcept;
+	void remove(const char* name) noexcept;
+	bool has(const char* name) const noexcept;
+	runtime_component* get(const char* name) const noexcept;
+
+	// Name lookups hash the name; hot paths resolve it once and then get by index.
+	// Returns INVALID_COMPONENT_INDEX for a name no locator has added yet.
+	static component_index runtime_index(const char* name) noexcept;
+	runtime_component* get(component_index idx) const noexcept;
+
+	// Removes the entity from every pool, static and runtime.
+	void remove_entity(entity_id id) noexcept;
+
+	void set_budget(memory_budget* budget) noexcept;
+	inline memory_budget* budget() const noexcept { return budget_; }
+
+	size_t memory_usage() const noexcept;
+
+	template<ecs_component T>
+	size_t memory_usage() const noexcept;
+
+	template<typename fn_t>
+	void visit_memory_usage(fn_t&& fn) const noexcept;
+
+	void shrink_to_fit() noexcept;
+
+	template<ecs_component... component_t>
+	cached_query<component_t...>* query() noexcept;
+
+	template<ecs_component... component_t>
+	void remove_query() noexcept;
+
+	// Pools whose values are not nothrow copy constructible are left untouched.
+	bool restore_from(const component_locator& other) noexcept;
+	bool clone_to(component_locator& other) const noexcept;
+
 private:
 
 	struct _type_erasure_storage
 	{
 		void* p = nullptr;
 		void (*deleter)(void*) = nullptr;
+		size_t (*memory_usage)(const void*) = nullptr;
+		void (*shrink_to_fit)(void*) = nullptr;
+		void (*set_budget)(void*, memory_budget*) = nullptr;
+		void* (*create)(const void* prototype) = nullptr;
+		void (*clear)(void*) = nullptr;
+		void (*erase)(void*, entity_id) = nullptr;
+		bool (*restore)(void*, const void*) = nullptr;
+		// Static and runtime types share the index space; only runtime slots hold
+		// a runtime_component.
+		bool runtime = false;
 	};
 
-	using container_t = std::array <_type_erasure_storage, MAX_SIZE>;
-	using component_index = uint32_t;
+	struct _query_storage
+	{
+		void* p = nullptr;
+		void (*deleter)(void*) = nullptr;
+	};
 
-	static constexpr component_index INVALID_COMPONENT_INDEX_ = std::numeric_limits<component_index>::max();
+	using container_t = dynamic_array<_type_erasure_storage>;
+	using queries_t = dynamic_array<_query_storage>;
 
+	// Type indices are shared by every locator, possibly living on different
+	// threads; assigning one takes the lock, reading one does not.
+	static inline std::mutex types_mutex_;
 	static inline component_index next_component_index_ = 0;
-	container_t container_ = {};
+	container_t container_;
+	queries_t queries_;
+	memory_budget* budget_ = nullptr;
+
+	static inline std::atomic<size_t> next_query_index_ = 0;
+
+	struct _runtime_type
+	{
+		dynamic_array<char> name;
+		component_index index = INVALID_COMPONENT_INDEX;
+	};
+
+	// Open addressing table of runtime type names. Entries are published under
+	// types_mutex_ and never moved or removed, so lookups probe it without the lock.
+	struct _runtime_types
+	{
+		static constexpr size_type SLOTS = 2 * MAX_SIZE;
+
+		std::atomic<_runtime_type*> slots[SLOTS];
+
+		~_runtime_types() noexcept;
+	};
+
+	static inline _runtime_types runtime_types_;
 
 	template<ecs_component T>
-	component_index& type_index() const noexcept;
+	std::atomic<component_index>& type_index() const noexcept;
 
 	template<ecs_component T>
 	component_index acquire_type_index() noexcept;
+
+	template<ecs_component T, template<typename> typename Allocator>
+	static _type_erasure_storage make_storage_() noexcept;
+
+	template<typename Q>
+	static size_t query_index_() noexcept;
+
+	static size_type runtime_slot_(const char* name) noexcept;
+	static component_index acquire_runtime_type_index_(const char* name) noexcept;
+
+	static _type_erasure_storage make_runtime_storage_() noexcept;
 };
 
 } // namespace ecs
@@ -13,7 +13,12 @@ inline T* component_locator::add() noexcept
 
 	component_index idx = acquire_type_index<T>();
 
-	if (idx == INVALID_COMPONENT_INDEX_ || idx >= MAX_SIZE)
+	if (idx == INVALID_COMPONENT_INDEX || idx >= MAX_SIZE)
+	{
+		return nullptr;
+	}
+
+	if (idx >= container_.size() && !container_.resize(idx + 1))
 	{
 		return nullptr;
 	}
@@ -34,27 +39,22 @@ inline T* component_locator::add() noexcept
 		}
 	}
 
-	_type_erasure_storage storage {};
-
+	_type_erasure_storage storage = make_storage_<T, Allocator>();
 	storage.p = static_cast<void*>(std::construct_at(p));
-	storage.deleter = [](void* ptr)
-	{
-		T* p = static_cast<T*>(ptr);
-		std::destroy_at(p);
-		allocator_t{}.deallocate(p, 1);
-	};
 
 	container_[idx] = storage;
 
-	return static_cast<T*>(storage.p);
+	p->set_budget(budget_);
+
+	return p;
 }
 
 template<ecs_component T>
 inline void component_locator::remove() noexcept
 {
-	component_index idx = type_index<T>();
+	component_index idx = type_index<T>().load(std::memory_order_acquire);
 
-	if (idx == INVALID_COMPONENT_INDEX_ || idx >= MAX_SIZE)
+	if (idx == INVALID_COMPONENT_INDEX || idx >= container_.size())
 	{
 		return;
 	}
@@ -68,8 +68,7 @@ inline void component_locator::remove() noexcept
 
 	storage.deleter(storage.p);
 
-	storage.p = nullptr;
-	storage.deleter = nullptr;
+	storage = {};
 }
 
 template<ecs_component T>
@@ -82,9 +81,9 @@ inline bool component_locator::has() const noexcept
 template<ecs_component T>
 inline bool component_locator::has(T*& out) const noexcept
 {
-	component_index idx = type_index<T>();
+	component_index idx = type_index<T>().load(std::memory_order_acquire);
 
-	if (idx == INVALID_COMPONENT_INDEX_ || idx >= MAX_SIZE)
+	if (idx == INVALID_COMPONENT_INDEX || idx >= container_.size())
 	{
 		out = nullptr;
 		return false;
@@ -114,26 +113,180 @@ inline T* component_locator::get() const noexcept
 	return nullptr;
 }
 
+template<ecs_component... component_t>
+inline cached_query<component_t...>* component_locator::query() noexcept
+{
+	using query_t = cached_query<component_t...>;
+	using allocator_t = default_allocator<query_t>;
+
+	size_t idx = query_index_<query_t>();
+
+	if (idx >= queries_.size() && !queries_.resize(idx + 1))
+	{
+		return nullptr;
+	}
+
+	_query_storage& storage = queries_[idx];
+
+	if (!storage.p)
+	{
+		query_t* p = allocator_t{}.allocate(1);
+
+		if (p == nullptr)
+		{
+			return nullptr;
+		}
+
+		storage.p = static_cast<void*>(std::construct_at(p));
+		storage.deleter = [](void* ptr)
+		{
+			query_t* p = static_cast<query_t*>(ptr);
+			std::destroy_at(p);
+			allocator_t{}.deallocate(p, 1);
+		};
+	}
+
+	query_t* q = static_cast<query_t*>(storage.p);
+
+	if (!q->valid() && !q->bind(get<component_t>()...))
+	{
+		return nullptr;
+	}
+
+	return q;
+}
+
+template<ecs_component... component_t>
+inline void component_locator::remove_query() noexcept
+{
+	size_t idx = query_index_<cached_query<component_t...>>();
+
+	if (idx >= queries_.size() || !queries_[idx].p)
+	{
+		return;
+	}
+
+	queries_[idx].deleter(queries_[idx].p);
+	queries_[idx] = {};
+}
+
+template<ecs_component T>
+inline size_t component_locator::memory_usage() const noexcept
+{
+	T* ptr = nullptr;
+	if (has(ptr))
+	{
+		return ptr->memory_usage();
+	}
+
+	return 0;
+}
+
+template<typename fn_t>
+inline void component_locator::visit_memory_usage(fn_t&& fn) const noexcept
+{
+	for (container_t::size_type idx = 0; idx < container_.size(); ++idx)
+	{
+		if (container_[idx].p)
+		{
+			fn(static_cast<size_type>(idx), container_[idx].memory_usage(container_[idx].p));
+		}
+	}
+}
+
 template<ecs_component T>
-inline component_locator::component_index& component_locator::type_index() const noexcept
+inline std::atomic<component_locator::component_index>& component_locator::type_index() const noexcept
+{
+	static std::atomic<component_index> index = INVALID_COMPONENT_INDEX;
+	return index;
+}
+
+template<ecs_component T, template<typename> typename Allocator>
+inline component_locator::_type_erasure_storage component_locator::make_storage_() noexcept
+{
+	using allocator_t = Allocator<T>;
+	using value_type = typename T::value_type;
+
+	_type_erasure_storage storage {};
+
+	storage.deleter = [](void* ptr)
+	{
+		T* p = static_cast<T*>(ptr);
+		std::destroy_at(p);
+		allocator_t{}.deallocate(p, 1);
+	};
+	storage.memory_usage = [](const void* ptr)
+	{
+		return static_cast<const T*>(ptr)->memory_usage();
+	};
+	storage.shrink_to_fit = [](void* ptr)
+	{
+		static_cast<T*>(ptr)->shrink_to_fit();
+	};
+	storage.set_budget = [](void* ptr, memory_budget* budget)
+	{
+		static_cast<T*>(ptr)->set_budget(budget);
+	};
+	storage.create = [](const void*) -> void*
+	{
+		T* p = allocator_t{}.allocate(1);
+
+		if (p == nullptr)
+		{
+			return nullptr;
+		}
+
+		return static_cast<void*>(std::construct_at(p));
+	};
+	storage.clear = [](void* ptr)
+	{
+		static_cast<T*>(ptr)->clear();
+	};
+	storage.erase = [](void* ptr, entity_id id)
+	{
+		static_cast<T*>(ptr)->remove(id);
+	};
+
+	if constexpr (std::is_nothrow_copy_constructible_v<value_type>)
+	{
+		storage.restore = [](void* dst, const void* src)
+		{
+			return static_cast<T*>(dst)->restore_from(*static_cast<const T*>(src));
+		};
+	}
+
+	return storage;
+}
+
+template<typename Q>
+inline size_t component_locator::query_index_() noexcept
 {
-	static component_index index = INVALID_COMPONENT_INDEX_;
+	static const size_t index = next_query_index_.fetch_add(1, std::memory_order_relaxed);
 	return index;
 }
 
 template<ecs_component T>
 inline component_locator::component_index component_locator::acquire_type_index() noexcept
 {
-	component_index& index = type_index<T>();
+	std::atomic<component_index>& index = type_index<T>();
+	component_index idx = index.load(std::memory_order_acquire);
+
+	if (idx != INVALID_COMPONENT_INDEX)
+		return idx;
 
-	if (index != INVALID_COMPONENT_INDEX_)
-		return index;
+	std::lock_guard<std::mutex> lock(types_mutex_);
+
+	idx = index.load(std::memory_order_relaxed);
+
+	if (idx != INVALID_COMPONENT_INDEX)
+		return idx;
 
 	if (next_component_index_ >= MAX_SIZE)
-		return INVALID_COMPONENT_INDEX_;
+		return INVALID_COMPONENT_INDEX;
 
-	index = next_component_index_++;
-	return index;
+	idx = next_component_index_++;
+	index.store(idx, std::memory_order_release);
+	return idx;
 }
 
 } // namespace ecs
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "ecs/entity_id.h"
+
+namespace ecs
+{
+
+// Membership notifications of a pool. on_insert fires after an entity gains the
+// component, on_erase before it loses it, on_assign after an existing value was
+// overwritten through set/emplace or flagged with touch(), on_reset after the
+// contents were replaced wholesale (clear, restore) and on_detach when the pool
+// is destroyed.
+struct component_observer
+{
+	void* context = nullptr;
+
+	void (*on_insert)(void*, entity_id) = nullptr;
+	void (*on_erase)(void*, entity_id) = nullptr;
+	void (*on_assign)(void*, entity_id) = nullptr;
+	void (*on_reset)(void*) = nullptr;
+	void (*on_detach)(void*) = nullptr;
+};
+
+} // namespace ecs
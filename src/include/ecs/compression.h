@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+
+namespace ecs
+{
+
+// Byte-level LZ77 codec in the spirit of LZ4: a stream of sequences, each a token
+// with literal and match lengths, the literals themselves and a 16-bit backwards
+// offset. Fast enough to run on the simulation thread and effective on the column
+// layout components are packed in, where values repeat byte patterns.
+
+// Worst-case compressed size of size bytes.
+size_t compress_bound(size_t size) noexcept;
+
+// Returns the compressed size, 0 when capacity is too small.
+size_t compress(const void* src, size_t size, void* dst, size_t capacity) noexcept;
+
+// Decodes src into exactly size bytes; false on malformed or truncated input.
+bool decompress(const void* src, size_t src_size, void* dst, size_t size) noexcept;
+
+} // namespace ecs
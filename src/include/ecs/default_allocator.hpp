@@ -17,7 +17,7 @@ inline default_allocator<T>::value_type* default_allocator<T>::allocate(size_t n
 template<typename T>
 inline void default_allocator<T>::deallocate(value_type* p, size_t n) noexcept
 {
-	::operator delete(static_cast<void*>(p), std::align_val_t{ alignof(T) }, std::nothrow);
+	::operator delete(static_cast<void*>(p), n * sizeof(T), std::align_val_t{ alignof(T) });
 }
 
 } // namespace ecs
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "ecs/entity_id.h"
+#include "ecs/default_allocator.h"
+#include "ecs/memory_budget.h"
+#include "ecs/sparse_index.h"
+#include "ecs/dynamic_array.h"
+#include "ecs/component_observer.h"
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+
+namespace ecs
+{
+
+// Id side of a sparse set pool, shared by abstract_component and runtime_component:
+// the dense ids, the sparse index from ids to dense slots, the memory budget and
+// the observers. It knows nothing about values; a pool keeps them in a parallel
+// array and moves them along with the ids.
+template<std::unsigned_integral index_t>
+struct dense_set
+{
+	using size_type = uint32_t;
+	using index_type = index_t;
+
+	static constexpr size_type MIN_CAPACITY = 16;
+
+	inline size_type size() const noexcept { return size_; }
+	inline size_type capacity() const noexcept { return capacity_; }
+	inline bool empty() const noexcept { return size_ == 0; }
+
+	inline memory_budget* budget() const noexcept { return budget_; }
+
+	entity_id get_id(index_type idx) const noexcept;
+
+	bool subscribe(const component_observer& observer) noexcept;
+	void unsubscribe(const void* context) noexcept;
+
+protected:
+
+	dense_set() noexcept = default;
+	~dense_set() noexcept;
+
+	dense_set(const dense_set&) = delete;
+	dense_set& operator=(const dense_set&) = delete;
+
+	static constexpr index_type INVALID_INDEX = std::numeric_limits<index_type>::max();
+
+	using ids_allocator_t = default_allocator<entity_id>;
+	using entity_to_index_t = sparse_index<index_type>;
+
+	entity_id* id_of_index_ = nullptr;
+	entity_to_index_t index_of_id_;
+
+	size_type size_ = 0;
+	size_type capacity_ = 0;
+
+	memory_budget* budget_ = nullptr;
+
+	// Same idea as sparse_index versions: equal non-zero tags mean equal dense ids.
+	// Zeroed by the writer whenever the ids change and tagged lazily when read.
+	mutable std::atomic<uint64_t> ids_version_ = 0;
+	static inline std::atomic<uint64_t> next_ids_version_ = 1;
+
+	dynamic_array<component_observer> observers_;
+
+	index_type find_(entity_id id) const noexcept;
+	// Slot another generation of id's index holds, to be evicted before id is
+	// inserted. False when that generation is newer than id: id is a dead handle
+	// and must not be inserted.
+	bool find_stale_(entity_id id, index_type& stale) const noexcept;
+
+	// Bookkeeping of a slot appended at size_ or swap-removed at idx; the pool
+	// constructs or moves the value itself.
+	index_type push_(entity_id id) noexcept;
+	void pop_(index_type idx, entity_id id) noexcept;
+	void reset_ids_() noexcept;
+
+	inline void ids_changed_() noexcept { ids_version_.store(0, std::memory_order_relaxed); }
+	uint64_t ids_version_tag_() const noexcept;
+
+	// Copies the sparse index and the dense ids of other; size_ is left to the
+	// caller, which copies the values.
+	bool copy_ids_from_(const dense_set& other) noexcept;
+
+	size_type next_capacity_(size_type required, size_type max_size) const noexcept;
+
+	// Replaces the id array with one of `capacity` slots and charges the budget
+	// value_bytes + sizeof(entity_id) per slot. relocate(capacity) does the same for
+	// the values and must leave them untouched when it returns false.
+	template<typename relocate_fn>
+	bool reallocate_(size_type capacity, size_t value_bytes, relocate_fn&& relocate) noexcept;
+
+	void detach_observers_() noexcept;
+
+	void notify_insert_(entity_id id) noexcept;
+	// Announces the ids appended at [first, size_) in one pass per observer.
+	void notify_insert_tail_(size_type first) noexcept;
+	void notify_erase_(entity_id id) noexcept;
+	void notify_assign_(entity_id id) noexcept;
+	void notify_reset_() noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/dense_set.hpp"
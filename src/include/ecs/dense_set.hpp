@@ -0,0 +1,322 @@
+#pragma once
+
+#include "ecs/dense_set.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ecs
+{
+
+template<std::unsigned_integral index_t>
+inline dense_set<index_t>::~dense_set() noexcept
+{
+	if (id_of_index_)
+	{
+		ids_allocator_t{}.deallocate(id_of_index_, capacity_);
+	}
+}
+
+template<std::unsigned_integral index_t>
+inline entity_id dense_set<index_t>::get_id(index_type idx) const noexcept
+{
+	if (idx >= size_)
+	{
+		return INVALID_ENTITY_ID;
+	}
+
+	return id_of_index_[idx];
+}
+
+template<std::unsigned_integral index_t>
+inline bool dense_set<index_t>::subscribe(const component_observer& observer) noexcept
+{
+	return observers_.emplace_back(observer) != nullptr;
+}
+
+template<std::unsigned_integral index_t>
+inline void dense_set<index_t>::unsubscribe(const void* context) noexcept
+{
+	for (size_t idx = observers_.size(); idx > 0; --idx)
+	{
+		if (observers_[idx - 1].context == context)
+		{
+			observers_[idx - 1] = observers_.back();
+			observers_.pop_back();
+		}
+	}
+}
+
+template<std::unsigned_integral index_t>
+inline dense_set<index_t>::index_type dense_set<index_t>::find_(entity_id id) const noexcept
+{
+	index_type idx = index_of_id_.find(id);
+
+	// The sparse index is keyed by the index part only; a slot holding another
+	// generation belongs to an entity that no longer exists.
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		if (idx != INVALID_INDEX && id_of_index_[idx] != id)
+		{
+			return INVALID_INDEX;
+		}
+	}
+
+	return idx;
+}
+
+template<std::unsigned_integral index_t>
+inline bool dense_set<index_t>::find_stale_(entity_id id, index_type& stale) const noexcept
+{
+	stale = INVALID_INDEX;
+
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		index_type idx = index_of_id_.find(id);
+
+		if (idx == INVALID_INDEX || id_of_index_[idx] == id)
+		{
+			return true;
+		}
+
+		// Serial number order, so it survives generations wrapping around.
+		if (static_cast<int32_t>(entity_generation(id) - entity_generation(id_of_index_[idx])) <= 0)
+		{
+			return false;
+		}
+
+		stale = idx;
+	}
+
+	return true;
+}
+
+template<std::unsigned_integral index_t>
+inline dense_set<index_t>::index_type dense_set<index_t>::push_(entity_id id) noexcept
+{
+	index_type idx = static_cast<index_type>(size_++);
+
+	index_of_id_.set(id, idx);
+	id_of_index_[idx] = id;
+	ids_changed_();
+
+	return idx;
+}
+
+template<std::unsigned_integral index_t>
+inline void dense_set<index_t>::pop_(index_type idx, entity_id id) noexcept
+{
+	index_type last = static_cast<index_type>(size_ - 1);
+
+	if (idx != last)
+	{
+		entity_id move = id_of_index_[last];
+
+		id_of_index_[idx] = move;
+		index_of_id_.set(move, idx);
+	}
+
+	id_of_index_[last] = INVALID_ENTITY_ID;
+	index_of_id_.reset(id);
+	ids_changed_();
+
+	--size_;
+}
+
+template<std::unsigned_integral index_t>
+inline void dense_set<index_t>::reset_ids_() noexcept
+{
+	for (size_type idx = 0; idx < size_; ++idx)
+	{
+		index_of_id_.reset(id_of_index_[idx]);
+	}
+
+	size_ = 0;
+	ids_changed_();
+}
+
+template<std::unsigned_integral index_t>
+inline uint64_t dense_set<index_t>::ids_version_tag_() const noexcept
+{
+	uint64_t version = ids_version_.load(std::memory_order_relaxed);
+
+	// Several snapshots may be taken from the same source at once, so the tag is
+	// claimed with a compare exchange instead of a plain store.
+	if (version == 0)
+	{
+		uint64_t fresh = next_ids_version_.fetch_add(1, std::memory_order_relaxed);
+		version = ids_version_.compare_exchange_strong(version, fresh, std::memory_order_relaxed) ? fresh : version;
+	}
+
+	return version;
+}
+
+template<std::unsigned_integral index_t>
+inline bool dense_set<index_t>::copy_ids_from_(const dense_set& other) noexcept
+{
+	if (!index_of_id_.copy_from(other.index_of_id_, budget_))
+	{
+		index_of_id_.clear();
+		ids_changed_();
+		return false;
+	}
+
+	uint64_t version = other.ids_version_tag_();
+
+	if (other.size_ > 0 && ids_version_.load(std::memory_order_relaxed) != version)
+	{
+		std::memcpy(id_of_index_, other.id_of_index_, sizeof(entity_id) * other.size_);
+	}
+
+	ids_version_.store(version, std::memory_order_relaxed);
+
+	return true;
+}
+
+template<std::unsigned_integral index_t>
+inline dense_set<index_t>::size_type dense_set<index_t>::next_capacity_(size_type required, size_type max_size) const noexcept
+{
+	size_type capacity = capacity_ ? capacity_ : MIN_CAPACITY;
+
+	while (capacity < required && capacity <= max_size / 2)
+	{
+		capacity *= 2;
+	}
+
+	return std::min(std::max(capacity, required), max_size);
+}
+
+template<std::unsigned_integral index_t>
+template<typename relocate_fn>
+inline bool dense_set<index_t>::reallocate_(size_type capacity, size_t value_bytes, relocate_fn&& relocate) noexcept
+{
+	if (capacity == capacity_)
+	{
+		return true;
+	}
+
+	size_t item_bytes = value_bytes + sizeof(entity_id);
+
+	if (budget_ && capacity > capacity_ && !budget_->try_acquire(item_bytes * (capacity - capacity_)))
+	{
+		return false;
+	}
+
+	entity_id* ids = capacity > 0 ? ids_allocator_t{}.allocate(capacity) : nullptr;
+
+	if ((capacity > 0 && !ids) || !relocate(capacity))
+	{
+		if (ids)
+		{
+			ids_allocator_t{}.deallocate(ids, capacity);
+		}
+
+		if (budget_ && capacity > capacity_)
+		{
+			budget_->release(item_bytes * (capacity - capacity_));
+		}
+
+		return false;
+	}
+
+	if (size_ > 0)
+	{
+		std::memcpy(ids, id_of_index_, sizeof(entity_id) * size_);
+	}
+
+	if (id_of_index_)
+	{
+		ids_allocator_t{}.deallocate(id_of_index_, capacity_);
+	}
+
+	if (budget_ && capacity < capacity_)
+	{
+		budget_->release(item_bytes * (capacity_ - capacity));
+	}
+
+	id_of_index_ = ids;
+	capacity_ = capacity;
+
+	return true;
+}
+
+template<std::unsigned_integral index_t>
+inline void dense_set<index_t>::detach_observers_() noexcept
+{
+	dynamic_array<component_observer> observers = std::move(observers_);
+
+	for (const component_observer& observer : observers)
+	{
+		if (observer.on_detach)
+		{
+			observer.on_detach(observer.context);
+		}
+	}
+}
+
+template<std::unsigned_integral index_t>
+inline void dense_set<index_t>::notify_insert_(entity_id id) noexcept
+{
+	for (const component_observer& observer : observers_)
+	{
+		if (observer.on_insert)
+		{
+			observer.on_insert(observer.context, id);
+		}
+	}
+}
+
+template<std::unsigned_integral index_t>
+inline void dense_set<index_t>::notify_insert_tail_(size_type first) noexcept
+{
+	for (const component_observer& observer : observers_)
+	{
+		if (!observer.on_insert)
+		{
+			continue;
+		}
+
+		for (size_type idx = first; idx < size_; ++idx)
+		{
+			observer.on_insert(observer.context, id_of_index_[idx]);
+		}
+	}
+}
+
+template<std::unsigned_integral index_t>
+inline void dense_set<index_t>::notify_erase_(entity_id id) noexcept
+{
+	for (const component_observer& observer : observers_)
+	{
+		if (observer.on_erase)
+		{
+			observer.on_erase(observer.context, id);
+		}
+	}
+}
+
+template<std::unsigned_integral index_t>
+inline void dense_set<index_t>::notify_assign_(entity_id id) noexcept
+{
+	for (const component_observer& observer : observers_)
+	{
+		if (observer.on_assign)
+		{
+			observer.on_assign(observer.context, id);
+		}
+	}
+}
+
+template<std::unsigned_integral index_t>
+inline void dense_set<index_t>::notify_reset_() noexcept
+{
+	for (const component_observer& observer : observers_)
+	{
+		if (observer.on_reset)
+		{
+			observer.on_reset(observer.context);
+		}
+	}
+}
+
+} // namespace ecs
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "ecs/abstract_component.h"
+
+#include <type_traits>
+
+namespace ecs
+{
+
+// Pool with a second, read-only copy of the dense array as it was at the last
+// swap_buffers(). Writers use the regular pool interface, also through an
+// abstract_component reference; readers on other threads use previous().
+//
+// The swap exchanges the value buffers in O(1) and copies the dense ids only if
+// they changed since the previous swap. The new back buffer is brought up to
+// date on the first access after the swap. Reader buffers are only reallocated
+// by swap_buffers(), so a view returned by previous() stays valid until the next
+// swap, which must not run while readers still use it.
+template<component_value T, storage_policy_concept P = default_storage_policy>
+requires std::is_trivially_copyable_v<T>
+struct double_buffered_component : abstract_component<T, P>
+{
+	using base_type = abstract_component<T, P>;
+
+	using typename base_type::value_type;
+	using typename base_type::pointer_type;
+	using typename base_type::const_pointer_type;
+	using typename base_type::size_type;
+	using typename base_type::index_type;
+	using typename base_type::const_iterator;
+
+	struct frame_view
+	{
+		const_pointer_type values = nullptr;
+		const entity_id* ids = nullptr;
+		size_type count = 0;
+
+		inline size_type size() const noexcept { return count; }
+		inline bool empty() const noexcept { return count == 0; }
+
+		inline const_iterator begin() const noexcept { return values; }
+		inline const_iterator end() const noexcept { return values + count; }
+
+		entity_id get_id(index_type idx) const noexcept;
+	};
+
+	~double_buffered_component() noexcept override;
+
+	frame_view previous() const noexcept;
+
+	// False if the reader buffers could not follow the pool's capacity; previous()
+	// keeps showing the last frame that was swapped in.
+	bool swap_buffers() noexcept;
+	void sync() noexcept;
+
+	size_t memory_usage() const noexcept;
+	void set_budget(memory_budget* budget) noexcept;
+
+protected:
+
+	double_buffered_component() noexcept;
+
+	using typename base_type::_proxy_storage;
+	using typename base_type::container_allocator_t;
+	using typename base_type::ids_allocator_t;
+
+	_proxy_storage* front_container_ = nullptr;
+	entity_id* front_ids_ = nullptr;
+	size_type front_size_ = 0;
+	size_type front_capacity_ = 0;
+	uint64_t front_ids_version_ = 0;
+
+	mutable bool back_is_stale_ = false;
+
+	void sync_() const noexcept;
+	bool resize_front_(size_type capacity) noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/double_buffered_component.hpp"
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "ecs/double_buffered_component.h"
+
+#include <cstring>
+#include <utility>
+
+namespace ecs
+{
+
+template<component_value T, storage_policy_concept P>
+requires std::is_trivially_copyable_v<T>
+inline entity_id double_buffered_component<T, P>::frame_view::get_id(index_type idx) const noexcept
+{
+	if (idx >= count)
+	{
+		return INVALID_ENTITY_ID;
+	}
+
+	return ids[idx];
+}
+
+template<component_value T, storage_policy_concept P>
+requires std::is_trivially_copyable_v<T>
+inline double_buffered_component<T, P>::double_buffered_component() noexcept
+{
+	this->sync_hook_ = [](const base_type& self) noexcept
+	{
+		static_cast<const double_buffered_component&>(self).sync_();
+	};
+}
+
+template<component_value T, storage_policy_concept P>
+requires std::is_trivially_copyable_v<T>
+inline double_buffered_component<T, P>::~double_buffered_component() noexcept
+{
+	resize_front_(0);
+}
+
+template<component_value T, storage_policy_concept P>
+requires std::is_trivially_copyable_v<T>
+inline double_buffered_component<T, P>::frame_view double_buffered_component<T, P>::previous() const noexcept
+{
+	if (!front_container_)
+	{
+		return {};
+	}
+
+	return { std::addressof(front_container_[0].data), front_ids_, front_size_ };
+}
+
+template<component_value T, storage_policy_concept P>
+requires std::is_trivially_copyable_v<T>
+inline bool double_buffered_component<T, P>::swap_buffers() noexcept
+{
+	// Nothing touched the pool since the last swap: the front already matches it.
+	if (back_is_stale_)
+	{
+		return true;
+	}
+
+	if (front_capacity_ != this->capacity_ && !resize_front_(this->capacity_))
+	{
+		return false;
+	}
+
+	std::swap(this->container_, front_container_);
+
+	uint64_t version = this->ids_version_tag_();
+
+	if (front_ids_version_ != version)
+	{
+		if (this->size_ > 0)
+		{
+			std::memcpy(front_ids_, this->id_of_index_, sizeof(entity_id) * this->size_);
+		}
+
+		front_ids_version_ = version;
+	}
+
+	front_size_ = this->size_;
+	back_is_stale_ = true;
+
+	return true;
+}
+
+template<component_value T, storage_policy_concept P>
+requires std::is_trivially_copyable_v<T>
+inline void double_buffered_component<T, P>::sync() noexcept
+{
+	sync_();
+}
+
+template<component_value T, storage_policy_concept P>
+requires std::is_trivially_copyable_v<T>
+inline size_t double_buffered_component<T, P>::memory_usage() const noexcept
+{
+	return base_type::memory_usage() + base_type::BYTES_PER_ITEM * front_capacity_;
+}
+
+template<component_value T, storage_policy_concept P>
+requires std::is_trivially_copyable_v<T>
+inline void double_buffered_component<T, P>::set_budget(memory_budget* budget) noexcept
+{
+	if (this->budget_ == budget)
+	{
+		return;
+	}
+
+	if (this->budget_)
+	{
+		this->budget_->release(base_type::BYTES_PER_ITEM * front_capacity_);
+	}
+
+	base_type::set_budget(budget);
+
+	if (this->budget_)
+	{
+		this->budget_->charge(base_type::BYTES_PER_ITEM * front_capacity_);
+	}
+}
+
+template<component_value T, storage_policy_concept P>
+requires std::is_trivially_copyable_v<T>
+inline void double_buffered_component<T, P>::sync_() const noexcept
+{
+	if (!back_is_stale_)
+	{
+		return;
+	}
+
+	if (front_size_ > 0)
+	{
+		std::memcpy(static_cast<void*>(this->container_), front_container_, sizeof(_proxy_storage) * front_size_);
+	}
+
+	back_is_stale_ = false;
+}
+
+template<component_value T, storage_policy_concept P>
+requires std::is_trivially_copyable_v<T>
+inline bool double_buffered_component<T, P>::resize_front_(size_type capacity) noexcept
+{
+	if (capacity == front_capacity_)
+	{
+		return true;
+	}
+
+	if (this->budget_ && capacity > front_capacity_ && !this->budget_->try_acquire(base_type::BYTES_PER_ITEM * (capacity - front_capacity_)))
+	{
+		return false;
+	}
+
+	// The old contents are about to be replaced by the swap, nothing to carry over.
+	_proxy_storage* container = nullptr;
+	entity_id* ids = nullptr;
+
+	if (capacity > 0)
+	{
+		container = container_allocator_t{}.allocate(capacity);
+		ids = ids_allocator_t{}.allocate(capacity);
+
+		if (!container || !ids)
+		{
+			if (container)
+			{
+				container_allocator_t{}.deallocate(container, capacity);
+			}
+
+			if (ids)
+			{
+				ids_allocator_t{}.deallocate(ids, capacity);
+			}
+
+			if (this->budget_ && capacity > front_capacity_)
+			{
+				this->budget_->release(base_type::BYTES_PER_ITEM * (capacity - front_capacity_));
+			}
+
+			return false;
+		}
+	}
+
+	if (front_container_)
+	{
+		container_allocator_t{}.deallocate(front_container_, front_capacity_);
+		ids_allocator_t{}.deallocate(front_ids_, front_capacity_);
+	}
+
+	if (this->budget_ && capacity < front_capacity_)
+	{
+		this->budget_->release(base_type::BYTES_PER_ITEM * (front_capacity_ - capacity));
+	}
+
+	front_container_ = container;
+	front_ids_ = ids;
+	front_size_ = 0;
+	front_capacity_ = capacity;
+	front_ids_version_ = 0;
+
+	return true;
+}
+
+} // namespace ecs
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "ecs/allocator_concept.h"
+#include "ecs/default_allocator.h"
+
+#include <cstddef>
+#include <type_traits>
+
+namespace ecs
+{
+
+// Minimal growable array for internal bookkeeping. Never throws: growth that
+// cannot be satisfied is reported through the return value.
+template<typename T, template<typename> typename Allocator = default_allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+struct dynamic_array
+{
+	using value_type		 = T;
+	using ref_type			 = value_type &;
+	using const_ref_type	 = value_type const &;
+	using pointer_type		 = value_type *;
+	using const_pointer_type = value_type const *;
+
+	using size_type = size_t;
+
+	using iterator = pointer_type;
+	using const_iterator = const_pointer_type;
+
+	dynamic_array() noexcept = default;
+	~dynamic_array() noexcept;
+
+	dynamic_array(dynamic_array&& other) noexcept;
+	dynamic_array& operator=(dynamic_array&& other) noexcept;
+
+	dynamic_array(const dynamic_array&) = delete;
+	dynamic_array& operator=(const dynamic_array&) = delete;
+
+	bool reserve(size_type capacity) noexcept;
+	bool resize(size_type size) noexcept
+	requires std::is_nothrow_default_constructible_v<value_type>;
+
+	bool assign(const_pointer_type first, size_type count) noexcept
+	requires std::is_nothrow_copy_constructible_v<value_type>;
+
+	template<typename... arg_t>
+	pointer_type emplace_back(arg_t&&... arg) noexcept
+	requires std::is_nothrow_constructible_v<value_type, arg_t...>;
+
+	void pop_back() noexcept;
+	void clear() noexcept;
+	void shrink_to_fit() noexcept;
+
+	inline size_type size() const noexcept { return size_; }
+	inline size_type capacity() const noexcept { return capacity_; }
+	inline bool empty() const noexcept { return size_ == 0; }
+
+	inline pointer_type data() noexcept { return data_; }
+	inline const_pointer_type data() const noexcept { return data_; }
+
+	inline ref_type operator[](size_type idx) noexcept { return data_[idx]; }
+	inline const_ref_type operator[](size_type idx) const noexcept { return data_[idx]; }
+
+	inline ref_type back() noexcept { return data_[size_ - 1]; }
+	inline const_ref_type back() const noexcept { return data_[size_ - 1]; }
+
+	inline iterator begin() noexcept { return data_; }
+	inline iterator end() noexcept { return data_ + size_; }
+	inline const_iterator begin() const noexcept { return data_; }
+	inline const_iterator end() const noexcept { return data_ + size_; }
+
+private:
+
+	using allocator_t = Allocator<T>;
+
+	pointer_type data_ = nullptr;
+	size_type size_ = 0;
+	size_type capacity_ = 0;
+
+	bool reallocate_(size_type capacity) noexcept;
+	bool grow_(size_type required) noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/dynamic_array.hpp"
@@ -0,0 +1,213 @@
+#pragma once
+
+#include "ecs/dynamic_array.h"
+
+#include <cstring>
+#include <memory>
+#include <utility>
+
+namespace ecs
+{
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+inline dynamic_array<T, Allocator>::~dynamic_array() noexcept
+{
+	clear();
+
+	if (data_)
+	{
+		allocator_t{}.deallocate(data_, capacity_);
+	}
+}
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+inline dynamic_array<T, Allocator>::dynamic_array(dynamic_array&& other) noexcept
+	: data_(std::exchange(other.data_, nullptr))
+	, size_(std::exchange(other.size_, 0))
+	, capacity_(std::exchange(other.capacity_, 0))
+{
+}
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+inline dynamic_array<T, Allocator>& dynamic_array<T, Allocator>::operator=(dynamic_array&& other) noexcept
+{
+	if (this != &other)
+	{
+		std::swap(data_, other.data_);
+		std::swap(size_, other.size_);
+		std::swap(capacity_, other.capacity_);
+	}
+
+	return *this;
+}
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+inline bool dynamic_array<T, Allocator>::reserve(size_type capacity) noexcept
+{
+	if (capacity <= capacity_)
+	{
+		return true;
+	}
+
+	return reallocate_(capacity);
+}
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+inline bool dynamic_array<T, Allocator>::resize(size_type size) noexcept
+requires std::is_nothrow_default_constructible_v<value_type>
+{
+	if (size > capacity_ && !grow_(size))
+	{
+		return false;
+	}
+
+	if (size > size_)
+	{
+		std::uninitialized_value_construct(data_ + size_, data_ + size);
+	}
+	else
+	{
+		std::destroy(data_ + size, data_ + size_);
+	}
+
+	size_ = size;
+	return true;
+}
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+inline bool dynamic_array<T, Allocator>::assign(const_pointer_type first, size_type count) noexcept
+requires std::is_nothrow_copy_constructible_v<value_type>
+{
+	clear();
+
+	if (!reserve(count))
+	{
+		return false;
+	}
+
+	if constexpr (std::is_trivially_copyable_v<value_type>)
+	{
+		if (count)
+		{
+			std::memcpy(static_cast<void*>(data_), first, count * sizeof(value_type));
+		}
+	}
+	else
+	{
+		std::uninitialized_copy_n(first, count, data_);
+	}
+
+	size_ = count;
+	return true;
+}
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+template<typename... arg_t>
+inline dynamic_array<T, Allocator>::pointer_type dynamic_array<T, Allocator>::emplace_back(arg_t&&... arg) noexcept
+requires std::is_nothrow_constructible_v<value_type, arg_t...>
+{
+	if (size_ == capacity_ && !grow_(size_ + 1))
+	{
+		return nullptr;
+	}
+
+	return std::construct_at(data_ + size_++, std::forward<arg_t>(arg)...);
+}
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+inline void dynamic_array<T, Allocator>::pop_back() noexcept
+{
+	if (empty())
+	{
+		return;
+	}
+
+	std::destroy_at(data_ + --size_);
+}
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+inline void dynamic_array<T, Allocator>::clear() noexcept
+{
+	std::destroy_n(data_, size_);
+	size_ = 0;
+}
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+inline void dynamic_array<T, Allocator>::shrink_to_fit() noexcept
+{
+	if (size_ == capacity_)
+	{
+		return;
+	}
+
+	if (size_ == 0)
+	{
+		allocator_t{}.deallocate(data_, capacity_);
+		data_ = nullptr;
+		capacity_ = 0;
+		return;
+	}
+
+	reallocate_(size_);
+}
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+inline bool dynamic_array<T, Allocator>::reallocate_(size_type capacity) noexcept
+{
+	pointer_type data = allocator_t{}.allocate(capacity);
+
+	if (data == nullptr)
+	{
+		return false;
+	}
+
+	if constexpr (std::is_trivially_copyable_v<value_type>)
+	{
+		if (size_)
+		{
+			std::memcpy(static_cast<void*>(data), data_, size_ * sizeof(value_type));
+		}
+	}
+	else
+	{
+		std::uninitialized_move_n(data_, size_, data);
+		std::destroy_n(data_, size_);
+	}
+
+	if (data_)
+	{
+		allocator_t{}.deallocate(data_, capacity_);
+	}
+
+	data_ = data;
+	capacity_ = capacity;
+
+	return true;
+}
+
+template<typename T, template<typename> typename Allocator>
+requires allocator_concept<Allocator, T> && std::is_nothrow_move_constructible_v<T>
+inline bool dynamic_array<T, Allocator>::grow_(size_type required) noexcept
+{
+	size_type capacity = capacity_ ? capacity_ * 2 : 8;
+
+	if (capacity < required)
+	{
+		capacity = required;
+	}
+
+	return reallocate_(capacity);
+}
+
+} // namespace ecs
@@ -1,7 +1,31 @@
 #pragma once
 
 #include "ecs/entity_id.h"
+#include "ecs/entity_id_allocator.h"
+#include "ecs/storage_policy.h"
+#include "ecs/dense_set.h"
 #include "ecs/abstract_component.h"
+#include "ecs/double_buffered_component.h"
 #include "ecs/default_allocator.h"
+#include "ecs/memory_budget.h"
+#include "ecs/runtime_component.h"
 #include "ecs/component_locator.h"
+#include "ecs/cached_query.h"
+#include "ecs/runtime_view.h"
+#include "ecs/aggregate.h"
+#include "ecs/prefab.h"
+#include "ecs/snapshot_ring.h"
 #include "ecs/system.h"
+#include "ecs/system_pipeline.h"
+#include "ecs/dynamic_array.h"
+#include "ecs/spatial_grid.h"
+#include "ecs/spatial_bvh.h"
+#include "ecs/world_streamer.h"
+#include "ecs/compression.h"
+#include "ecs/hibernation_store.h"
+#include "ecs/sharded_world.h"
+#include "ecs/frame_arena.h"
+#include "ecs/event_queue.h"
+#include "ecs/event_bus.h"
+#include "ecs/command_buffer.h"
+#include "ecs/thread_slot.h"
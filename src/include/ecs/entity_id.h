@@ -3,11 +3,78 @@
 #include <cstdint>
 #include <limits>
 
+// Build configuration, set through the build system:
+//   ECS_ENTITY_ID_64      64-bit ids made of a 32-bit index and a 32-bit generation.
+//                         Pools reject ids whose generation does not match the
+//                         entity stored under that index.
+//   ECS_MAX_ENTITY_COUNT  size of the index space, 512K by default.
+#ifndef ECS_MAX_ENTITY_COUNT
+#define ECS_MAX_ENTITY_COUNT (512u * 1024u)
+#endif
+
 namespace ecs
 {
 
+#if defined(ECS_ENTITY_ID_64)
+using entity_id = uint64_t;
+inline constexpr uint32_t ENTITY_GENERATION_BITS = 32;
+#else
 using entity_id = uint32_t;
+inline constexpr uint32_t ENTITY_GENERATION_BITS = 0;
+#endif
+
+using entity_index_type = uint32_t;
+using entity_generation_type = uint32_t;
+
 inline constexpr entity_id INVALID_ENTITY_ID = std::numeric_limits<entity_id>::max();
-inline constexpr entity_id MAX_ENTITY_COUNT = 512u * 1024u;
+inline constexpr entity_id MAX_ENTITY_COUNT = ECS_MAX_ENTITY_COUNT;
+
+static_assert(MAX_ENTITY_COUNT > 0 && MAX_ENTITY_COUNT < std::numeric_limits<entity_index_type>::max(), "ECS_MAX_ENTITY_COUNT must fit the 32-bit entity index");
+
+inline constexpr entity_index_type entity_index(entity_id id) noexcept
+{
+	return static_cast<entity_index_type>(id);
+}
+
+inline constexpr entity_generation_type entity_generation(entity_id id) noexcept
+{
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		return static_cast<entity_generation_type>(id >> 32);
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+inline constexpr entity_id make_entity_id(entity_index_type index, entity_generation_type generation = 0) noexcept
+{
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		return static_cast<entity_id>(generation) << 32 | index;
+	}
+	else
+	{
+		return static_cast<entity_id>(index);
+	}
+}
+
+// True for ids whose index part lies inside the configured index space.
+inline constexpr bool entity_id_in_range(entity_id id) noexcept
+{
+	return id != INVALID_ENTITY_ID && entity_index(id) < MAX_ENTITY_COUNT;
+}
+
+// Contiguous block of entity ids, [first, first + count).
+struct entity_range
+{
+	entity_id first = INVALID_ENTITY_ID;
+	uint32_t count = 0;
+
+	inline bool empty() const noexcept { return count == 0; }
+	inline entity_id end() const noexcept { return first + count; }
+	inline bool contains(entity_id id) const noexcept { return id >= first && id - first < count; }
+};
 
 } // namespace ecs
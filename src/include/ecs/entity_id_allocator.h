@@ -0,0 +1,82 @@
+#pragma once
+
+#include "ecs/entity_id.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace ecs
+{
+
+// Lock-free entity id source safe to call from any thread. Fresh ids come from
+// blocks reserved with one atomic add and cached per thread slot; released ids
+// go onto a Treiber stack whose head carries a tag bumped on every change, so a
+// pop racing with a pop/push pair of the same id cannot corrupt the list.
+// With 64-bit ids every index keeps a generation that release() bumps, so a
+// recycled index comes back as a new id and releasing a stale id is a no-op.
+// Without generations a second release of an id already freed is ignored.
+//
+// A thread's unused block stays in its lane when the thread exits; thread slots
+// are recycled, so the next thread given the slot continues the block.
+struct entity_id_allocator
+{
+	using size_type = uint32_t;
+
+	static constexpr size_type BLOCK_SIZE = 256;
+	static constexpr size_type MAX_LANES = 64;
+
+	explicit entity_id_allocator(entity_index_type capacity = MAX_ENTITY_COUNT) noexcept;
+	~entity_id_allocator() noexcept;
+
+	entity_id_allocator(const entity_id_allocator&) = delete;
+	entity_id_allocator& operator=(const entity_id_allocator&) = delete;
+
+	entity_id allocate() noexcept;
+	entity_range allocate(size_type count) noexcept;
+
+	void release(entity_id id) noexcept;
+
+	// Current id of an index, INVALID_ENTITY_ID past capacity.
+	entity_id id_at(entity_index_type index) const noexcept;
+
+	// Not thread-safe: forgets every id handed out so far, generations included.
+	void reset() noexcept;
+
+	inline entity_index_type capacity() const noexcept { return capacity_; }
+	inline entity_index_type high_water() const noexcept { return std::min(next_.load(std::memory_order_relaxed), capacity_); }
+
+private:
+
+	struct alignas(64) _lane
+	{
+		entity_index_type next = 0;
+		entity_index_type end = 0;
+	};
+
+	static constexpr entity_index_type INVALID_INDEX = std::numeric_limits<entity_index_type>::max();
+	// free_next_ value of an index that is not on the free list.
+	static constexpr entity_index_type NOT_FREE = INVALID_INDEX - 1;
+	static constexpr uint64_t EMPTY_HEAD = INVALID_INDEX;
+
+	entity_index_type capacity_;
+	std::atomic<entity_index_type> next_ = 0;
+
+	std::array<_lane, MAX_LANES> lanes_ = {};
+
+	std::atomic<uint64_t> free_head_ = EMPTY_HEAD;
+	std::atomic<entity_index_type>* free_next_ = nullptr;
+	std::atomic<entity_generation_type>* generations_ = nullptr;
+
+	entity_index_type pop_free_() noexcept;
+	void push_free_(entity_index_type index) noexcept;
+	// All count fresh ids or none; with partial, as many as remain up to count.
+	entity_range reserve_(size_type count, bool partial) noexcept;
+
+	static constexpr entity_index_type index_of_(uint64_t head) noexcept { return static_cast<entity_index_type>(head); }
+	static constexpr uint64_t head_of_(uint64_t previous, entity_index_type index) noexcept { return ((previous >> 32) + 1) << 32 | index; }
+};
+
+} // namespace ecs
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "ecs/dynamic_array.h"
+#include "ecs/event_queue.h"
+#include "ecs/frame_arena.h"
+
+#include <atomic>
+#include <cstddef>
+#include <span>
+
+namespace ecs
+{
+
+// One event_queue per event type, all published into a shared frame arena by
+// swap() at the frame boundary. queue() creates a type's queue and is not
+// thread-safe: register every type with it on the thread that owns the bus,
+// before producers start. emit() never creates one; events of an unregistered
+// type are dropped and it returns nullptr.
+struct event_bus
+{
+	explicit event_bus(frame_arena::size_type arena_chunk_size = frame_arena::DEFAULT_CHUNK_SIZE) noexcept;
+	~event_bus() noexcept;
+
+	event_bus(const event_bus&) = delete;
+	event_bus& operator=(const event_bus&) = delete;
+
+	template<typename E>
+	event_queue<E>* queue() noexcept;
+
+	// Existing queue of E, nullptr if the type was never registered.
+	template<typename E>
+	event_queue<E>* find() const noexcept;
+
+	template<typename E>
+	E* emit(const E& event) noexcept;
+
+	template<typename E>
+	std::span<const E> read() const noexcept;
+
+	bool swap() noexcept;
+	void clear() noexcept;
+
+	inline const frame_arena& arena() const noexcept { return arena_; }
+
+private:
+
+	struct _queue_storage
+	{
+		void* p = nullptr;
+		void (*deleter)(void*) = nullptr;
+		bool (*publish)(void*, frame_arena&) = nullptr;
+		void (*clear)(void*) = nullptr;
+	};
+
+	dynamic_array<_queue_storage> queues_;
+	frame_arena arena_;
+
+	static inline std::atomic<size_t> next_queue_index_ = 0;
+
+	template<typename E>
+	static size_t queue_index_() noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/event_bus.hpp"
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "ecs/event_bus.h"
+#include "ecs/default_allocator.h"
+
+#include <memory>
+
+namespace ecs
+{
+
+template<typename E>
+inline event_queue<E>* event_bus::queue() noexcept
+{
+	using queue_t = event_queue<E>;
+	using allocator_t = default_allocator<queue_t>;
+
+	size_t idx = queue_index_<E>();
+
+	if (idx < queues_.size() && queues_[idx].p)
+	{
+		return static_cast<queue_t*>(queues_[idx].p);
+	}
+
+	if (idx >= queues_.size() && !queues_.resize(idx + 1))
+	{
+		return nullptr;
+	}
+
+	queue_t* p = allocator_t{}.allocate(1);
+
+	if (p == nullptr)
+	{
+		return nullptr;
+	}
+
+	_queue_storage storage {};
+
+	storage.p = std::construct_at(p);
+	storage.deleter = [](void* ptr)
+	{
+		queue_t* queue = static_cast<queue_t*>(ptr);
+		std::destroy_at(queue);
+		allocator_t{}.deallocate(queue, 1);
+	};
+	storage.publish = [](void* ptr, frame_arena& arena)
+	{
+		return static_cast<queue_t*>(ptr)->publish(arena);
+	};
+	storage.clear = [](void* ptr)
+	{
+		static_cast<queue_t*>(ptr)->clear();
+	};
+
+	queues_[idx] = storage;
+
+	return p;
+}
+
+template<typename E>
+inline event_queue<E>* event_bus::find() const noexcept
+{
+	size_t idx = queue_index_<E>();
+
+	if (idx >= queues_.size())
+	{
+		return nullptr;
+	}
+
+	return static_cast<event_queue<E>*>(queues_[idx].p);
+}
+
+template<typename E>
+inline E* event_bus::emit(const E& event) noexcept
+{
+	event_queue<E>* events = find<E>();
+	return events ? events->emit(event) : nullptr;
+}
+
+template<typename E>
+inline std::span<const E> event_bus::read() const noexcept
+{
+	const event_queue<E>* events = find<E>();
+	return events ? events->events() : std::span<const E>{};
+}
+
+template<typename E>
+inline size_t event_bus::queue_index_() noexcept
+{
+	static const size_t index = next_queue_index_.fetch_add(1, std::memory_order_relaxed);
+	return index;
+}
+
+} // namespace ecs
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "ecs/dynamic_array.h"
+#include "ecs/frame_arena.h"
+#include "ecs/thread_slot.h"
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+namespace ecs
+{
+
+// Events of one type, written during a frame and read during the next. Each
+// producer thread appends to its own lane without locking; publish() runs at the
+// frame boundary with producers quiescent, concatenates the lanes into a single
+// contiguous block of the frame arena and empties them. Lanes keep their
+// capacity, so a steady event rate performs no heap allocation.
+//
+// Events published in the same frame are ordered by producer thread slot, then
+// by emission order within a thread.
+template<typename E>
+requires std::is_trivially_copyable_v<E>
+struct event_queue
+{
+	using value_type = E;
+	using size_type = uint32_t;
+
+	static constexpr size_type MAX_LANES = 64;
+
+	event_queue() noexcept = default;
+
+	event_queue(const event_queue&) = delete;
+	event_queue& operator=(const event_queue&) = delete;
+
+	E* emit(const E& event) noexcept;
+
+	template<typename... arg_t>
+	E* emplace(arg_t&&... arg) noexcept
+	requires std::is_nothrow_constructible_v<E, arg_t...>;
+
+	bool publish(frame_arena& arena) noexcept;
+	void clear() noexcept;
+
+	inline std::span<const E> events() const noexcept { return { published_, published_count_ }; }
+
+	size_type pending() const noexcept;
+
+private:
+
+	struct alignas(64) _lane
+	{
+		dynamic_array<E> events;
+	};
+
+	std::array<_lane, MAX_LANES> lanes_;
+	std::atomic<uint64_t> active_lanes_ = 0;
+
+	// Threads beyond MAX_LANES share one lane behind a lock.
+	_lane overflow_;
+	std::atomic_flag overflow_lock_;
+
+	const E* published_ = nullptr;
+	size_type published_count_ = 0;
+};
+
+} // namespace ecs
+
+#include "ecs/event_queue.hpp"
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "ecs/event_queue.h"
+
+#include <cstring>
+#include <utility>
+
+namespace ecs
+{
+
+template<typename E>
+requires std::is_trivially_copyable_v<E>
+inline E* event_queue<E>::emit(const E& event) noexcept
+{
+	return emplace(event);
+}
+
+template<typename E>
+requires std::is_trivially_copyable_v<E>
+template<typename... arg_t>
+inline E* event_queue<E>::emplace(arg_t&&... arg) noexcept
+requires std::is_nothrow_constructible_v<E, arg_t...>
+{
+	uint32_t slot = thread_slot();
+
+	if (slot < MAX_LANES)
+	{
+		dynamic_array<E>& events = lanes_[slot].events;
+
+		if (events.empty())
+		{
+			active_lanes_.fetch_or(uint64_t{ 1 } << slot, std::memory_order_relaxed);
+		}
+
+		return events.emplace_back(std::forward<arg_t>(arg)...);
+	}
+
+	while (overflow_lock_.test_and_set(std::memory_order_acquire))
+	{
+		overflow_lock_.wait(true, std::memory_order_relaxed);
+	}
+
+	E* event = overflow_.events.emplace_back(std::forward<arg_t>(arg)...);
+
+	overflow_lock_.clear(std::memory_order_release);
+	overflow_lock_.notify_one();
+	return event;
+}
+
+template<typename E>
+requires std::is_trivially_copyable_v<E>
+inline bool event_queue<E>::publish(frame_arena& arena) noexcept
+{
+	uint64_t active = active_lanes_.exchange(0, std::memory_order_acquire);
+	size_t total = pending();
+
+	published_ = nullptr;
+	published_count_ = 0;
+
+	if (total == 0)
+	{
+		return true;
+	}
+
+	E* merged = arena.template allocate<E>(total);
+	bool stored = merged != nullptr;
+
+	auto drain = [&](dynamic_array<E>& events)
+	{
+		if (stored && !events.empty())
+		{
+			std::memcpy(static_cast<void*>(merged + published_count_), events.data(), sizeof(E) * events.size());
+			published_count_ += static_cast<size_type>(events.size());
+		}
+
+		events.clear();
+	};
+
+	for (; active != 0; active &= active - 1)
+	{
+		drain(lanes_[std::countr_zero(active)].events);
+	}
+
+	drain(overflow_.events);
+
+	published_ = stored ? merged : nullptr;
+	return stored;
+}
+
+template<typename E>
+requires std::is_trivially_copyable_v<E>
+inline void event_queue<E>::clear() noexcept
+{
+	for (_lane& lane : lanes_)
+	{
+		lane.events.clear();
+	}
+
+	overflow_.events.clear();
+	active_lanes_.store(0, std::memory_order_relaxed);
+
+	published_ = nullptr;
+	published_count_ = 0;
+}
+
+template<typename E>
+requires std::is_trivially_copyable_v<E>
+inline event_queue<E>::size_type event_queue<E>::pending() const noexcept
+{
+	size_t total = overflow_.events.size();
+
+	for (const _lane& lane : lanes_)
+	{
+		total += lane.events.size();
+	}
+
+	return static_cast<size_type>(total);
+}
+
+} // namespace ecs
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "ecs/dynamic_array.h"
+
+#include <cstddef>
+
+namespace ecs
+{
+
+// Bump allocator whose contents live for one frame. reset() keeps the memory, and
+// after a frame that spilled into extra chunks it folds them into a single one,
+// so allocation settles into pointer bumps over one block once warmed up.
+struct frame_arena
+{
+	using size_type = size_t;
+
+	static constexpr size_type DEFAULT_CHUNK_SIZE = 64 * 1024;
+	static constexpr size_type CHUNK_ALIGNMENT = 64;
+
+	explicit frame_arena(size_type chunk_size = DEFAULT_CHUNK_SIZE) noexcept;
+	~frame_arena() noexcept;
+
+	frame_arena(const frame_arena&) = delete;
+	frame_arena& operator=(const frame_arena&) = delete;
+
+	void* allocate(size_type bytes, size_type alignment) noexcept;
+
+	template<typename T>
+	inline T* allocate(size_type count) noexcept
+	{
+		return static_cast<T*>(allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	bool reserve(size_type bytes) noexcept;
+
+	void reset() noexcept;
+	void release() noexcept;
+
+	inline size_type used() const noexcept { return used_; }
+	size_type capacity() const noexcept;
+
+private:
+
+	struct _chunk
+	{
+		std::byte* data = nullptr;
+		size_type size = 0;
+	};
+
+	dynamic_array<_chunk> chunks_;
+	size_type chunk_size_;
+	size_type current_ = 0;
+	size_type offset_ = 0;
+	size_type used_ = 0;
+
+	bool add_chunk_(size_type size) noexcept;
+	static void free_chunk_(const _chunk& chunk) noexcept;
+};
+
+} // namespace ecs
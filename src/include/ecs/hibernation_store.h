@@ -0,0 +1,135 @@
+#pragma once
+
+#include "ecs/component_locator.h"
+#include "ecs/dynamic_array.h"
+#include "ecs/section_codec.h"
+#include "ecs/sparse_index.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace ecs
+{
+
+// Cold storage for dormant entities. hibernate() pulls the registered components
+// of a batch of entities out of their live pools and keeps them as compressed
+// blocks of up to BLOCK_ENTITIES entities, so the dense arrays hot systems iterate only hold active entities. wake()
+// decompresses each touched block once and reinserts the requested entities in
+// bulk; blocks that end up mostly awake are recompressed with the rest.
+//
+// Components of types that were not registered stay in their pools. Values are
+// kept as raw bytes, so only trivially copyable components can be registered.
+struct hibernation_store
+{
+	using size_type = uint32_t;
+
+	static constexpr size_type BLOCK_ENTITIES = 1024;
+
+	hibernation_store() noexcept = default;
+	~hibernation_store() noexcept = default;
+
+	hibernation_store(const hibernation_store&) = delete;
+	hibernation_store& operator=(const hibernation_store&) = delete;
+
+	template<ecs_component T>
+	requires std::is_trivially_copyable_v<typename T::value_type>
+	bool register_component() noexcept;
+
+	// Both return the number of entities that changed state; ids that are already
+	// in the requested state are skipped.
+	size_type hibernate(component_locator& world, const entity_id* ids, size_type count) noexcept;
+	size_type wake(component_locator& world, const entity_id* ids, size_type count) noexcept;
+
+	// Forgets dormant entities without restoring them, e.g. when they get destroyed.
+	size_type discard(const entity_id* ids, size_type count) noexcept;
+
+	bool hibernating(entity_id id) const noexcept;
+
+	void clear() noexcept;
+	void shrink_to_fit() noexcept;
+
+	inline size_type size() const noexcept { return size_; }
+	inline size_t raw_bytes() const noexcept { return raw_bytes_; }
+	inline size_t compressed_bytes() const noexcept { return compressed_bytes_; }
+
+	size_t memory_usage() const noexcept;
+
+private:
+
+	// gather copies values out without touching the pools; erase removes them once
+	// they are safely stored. insert flags the ids it could not insert in rejected.
+	// Uncompressed layout: _block_header, entity ids, then one section per codec
+	// that found anything, made of a _section_header, the slots of the owning
+	// entities in the id list and the packed values.
+	struct _block_header
+	{
+		size_type entity_count;
+		size_type section_count;
+	};
+
+	struct _section_header
+	{
+		uint32_t codec;
+		size_type count;
+	};
+
+	struct _block
+	{
+		dynamic_array<std::byte> data;
+		// One bit per slot, set while its entity is dormant in this block. Waking
+		// part of a block does not repack it, so it keeps copies of woken entities.
+		dynamic_array<uint64_t> alive;
+		size_t raw_size = 0;
+		size_type entity_count = 0;
+		size_type live = 0;
+		size_type waking = 0;
+
+		inline bool alive_at(size_type slot) const noexcept { return (alive[slot / 64] >> (slot % 64) & 1) != 0; }
+		inline void kill(size_type slot) noexcept { alive[slot / 64] &= ~(uint64_t{ 1 } << (slot % 64)); }
+	};
+
+	static constexpr uint32_t INVALID_BLOCK = sparse_index<uint32_t>::INVALID_INDEX;
+	static constexpr uint32_t WAKING = INVALID_BLOCK - 1;
+
+	dynamic_array<section_codec> codecs_;
+
+	dynamic_array<_block> blocks_;
+	dynamic_array<uint32_t> free_blocks_;
+	sparse_index<uint32_t> block_of_;
+
+	size_type size_ = 0;
+	size_t raw_bytes_ = 0;
+	size_t compressed_bytes_ = 0;
+
+	// Scratch reused across calls. raw_ holds the uncompressed block being built or
+	// read, mask_ flags its entities that are leaving.
+	dynamic_array<std::byte> raw_;
+	dynamic_array<std::byte> packed_;
+	dynamic_array<std::max_align_t> values_;
+	dynamic_array<entity_id> ids_;
+	dynamic_array<entity_id> gathered_;
+	dynamic_array<uint32_t> slots_;
+	dynamic_array<uint32_t> owners_;
+	dynamic_array<uint32_t> touched_;
+	dynamic_array<uint8_t> mask_;
+	dynamic_array<uint8_t> rejected_;
+
+	size_type pack_(component_locator& world, const entity_id* ids, size_type entity_count) noexcept;
+	size_type release_(component_locator* world, const entity_id* ids, size_type count) noexcept;
+	void unpack_(component_locator& world) noexcept;
+	bool repack_(_block& block) noexcept;
+
+	bool store_(_block& block) noexcept;
+	void drop_(uint32_t index) noexcept;
+	uint32_t acquire_block_() noexcept;
+
+	bool append_(const void* bytes, size_t size) noexcept;
+	bool stage_values_(size_t bytes) noexcept;
+	static bool stage_(dynamic_array<std::byte>& buffer, size_t size) noexcept;
+	static bool fill_alive_(dynamic_array<uint64_t>& alive, size_type count) noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/hibernation_store.hpp"
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "ecs/hibernation_store.h"
+
+namespace ecs
+{
+
+template<ecs_component T>
+requires std::is_trivially_copyable_v<typename T::value_type>
+inline bool hibernation_store::register_component() noexcept
+{
+	section_codec codec = section_codec::make<T>();
+
+	for (const section_codec& registered : codecs_)
+	{
+		if (registered.insert == codec.insert)
+		{
+			return false;
+		}
+	}
+
+	return size_ == 0 && codecs_.emplace_back(codec) != nullptr;
+}
+
+} // namespace ecs
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+
+namespace ecs
+{
+
+// Byte budget shared by the pools of one or more worlds. Pools acquire from it
+// before growing and release into it when they shrink or die.
+struct memory_budget
+{
+	using size_type = size_t;
+
+	static constexpr size_type UNLIMITED = std::numeric_limits<size_type>::max();
+
+	explicit memory_budget(size_type limit = UNLIMITED) noexcept;
+
+	memory_budget(const memory_budget&) = delete;
+	memory_budget& operator=(const memory_budget&) = delete;
+
+	bool try_acquire(size_type bytes) noexcept;
+	void charge(size_type bytes) noexcept;
+	void release(size_type bytes) noexcept;
+
+	void set_limit(size_type limit) noexcept;
+
+	inline size_type limit() const noexcept { return limit_.load(std::memory_order_relaxed); }
+	inline size_type used() const noexcept { return used_.load(std::memory_order_relaxed); }
+	size_type available() const noexcept;
+
+private:
+	std::atomic<size_type> limit_;
+	std::atomic<size_type> used_ = 0;
+};
+
+} // namespace ecs
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "ecs/component_concept.h"
+#include "ecs/component_locator.h"
+#include "ecs/entity_id.h"
+#include "ecs/entity_id_allocator.h"
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+
+namespace ecs
+{
+
+// Component values captured once and stamped onto a block of entity ids. Every
+// pool is grown at most once per instantiate and then filled in one pass, so
+// spawning thousands of copies costs a few sequential writes per component.
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0) && (std::is_nothrow_copy_constructible_v<typename component_t::value_type> && ...)
+struct prefab
+{
+	using size_type = uint32_t;
+
+	prefab() noexcept = default;
+	explicit prefab(const typename component_t::value_type&... values) noexcept;
+
+	template<ecs_component T>
+	requires (std::same_as<T, component_t> || ...)
+	typename T::value_type& get() noexcept;
+
+	template<ecs_component T>
+	requires (std::same_as<T, component_t> || ...)
+	const typename T::value_type& get() const noexcept;
+
+	// Ids that already have one of the components keep that value; the prefab only
+	// adds what is missing. Entities past the returned count may have received some
+	// of the components when a pool ran out of room part way through.
+	entity_range instantiate(component_locator& world, entity_id first, size_type count) noexcept;
+	entity_range instantiate(entity_id first, size_type count, component_t*... pools) noexcept;
+
+	// Reserves a fresh contiguous block from ids; the block is not returned to it
+	// on failure.
+	entity_range instantiate(component_locator& world, entity_id_allocator& ids, size_type count) noexcept;
+
+private:
+
+	std::tuple<typename component_t::value_type...> values_ = {};
+
+	template<ecs_component T>
+	static constexpr size_t index_of_() noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/prefab.hpp"
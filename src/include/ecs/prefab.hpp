@@ -0,0 +1,91 @@
+#pragma once
+
+#include "ecs/prefab.h"
+
+#include <algorithm>
+
+namespace ecs
+{
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0) && (std::is_nothrow_copy_constructible_v<typename component_t::value_type> && ...)
+inline prefab<component_t...>::prefab(const typename component_t::value_type&... values) noexcept
+	: values_(values...)
+{
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0) && (std::is_nothrow_copy_constructible_v<typename component_t::value_type> && ...)
+template<ecs_component T>
+requires (std::same_as<T, component_t> || ...)
+inline typename T::value_type& prefab<component_t...>::get() noexcept
+{
+	return std::get<index_of_<T>()>(values_);
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0) && (std::is_nothrow_copy_constructible_v<typename component_t::value_type> && ...)
+template<ecs_component T>
+requires (std::same_as<T, component_t> || ...)
+inline const typename T::value_type& prefab<component_t...>::get() const noexcept
+{
+	return std::get<index_of_<T>()>(values_);
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0) && (std::is_nothrow_copy_constructible_v<typename component_t::value_type> && ...)
+inline entity_range prefab<component_t...>::instantiate(component_locator& world, entity_id first, size_type count) noexcept
+{
+	auto acquire = [&world]<ecs_component T>(T*) -> T*
+	{
+		T* pool = world.get<T>();
+		return pool ? pool : world.add<T>();
+	};
+
+	return instantiate(first, count, acquire(static_cast<component_t*>(nullptr))...);
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0) && (std::is_nothrow_copy_constructible_v<typename component_t::value_type> && ...)
+inline entity_range prefab<component_t...>::instantiate(entity_id first, size_type count, component_t*... pools) noexcept
+{
+	if (((pools == nullptr) || ...))
+	{
+		return { first, 0 };
+	}
+
+	size_type spawned = count;
+
+	((spawned = std::min(spawned, pools->fill(first, count, std::get<index_of_<component_t>()>(values_)))), ...);
+
+	return { first, spawned };
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0) && (std::is_nothrow_copy_constructible_v<typename component_t::value_type> && ...)
+inline entity_range prefab<component_t...>::instantiate(component_locator& world, entity_id_allocator& ids, size_type count) noexcept
+{
+	entity_range range = ids.allocate(count);
+
+	if (range.empty())
+	{
+		return range;
+	}
+
+	return instantiate(world, range.first, range.count);
+}
+
+template<ecs_component... component_t>
+requires (sizeof...(component_t) > 0) && (std::is_nothrow_copy_constructible_v<typename component_t::value_type> && ...)
+template<ecs_component T>
+inline constexpr size_t prefab<component_t...>::index_of_() noexcept
+{
+	size_t index = 0;
+	size_t found = sizeof...(component_t);
+
+	((std::same_as<T, component_t> && found == sizeof...(component_t) ? (found = index, ++index) : ++index), ...);
+
+	return found;
+}
+
+} // namespace ecs
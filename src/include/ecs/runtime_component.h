@@ -0,0 +1,148 @@
+#pragma once
+
+#include "ecs/dense_set.h"
+#include "ecs/dynamic_array.h"
+#include "ecs/entity_id.h"
+#include "ecs/memory_budget.h"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace ecs
+{
+
+enum class field_type : uint8_t
+{
+	int8,
+	uint8,
+	int16,
+	uint16,
+	int32,
+	uint32,
+	int64,
+	uint64,
+	float32,
+	float64,
+	entity,
+	bytes
+};
+
+struct component_field
+{
+	const char* name = nullptr;
+	field_type type = field_type::bytes;
+	uint32_t offset = 0;
+	uint32_t count = 1;
+};
+
+// Layout and lifetime of a component type known only at runtime. Null lifetime
+// hooks mean the value is trivial in that respect: zero-filled on construction,
+// relocated and copied with memcpy, nothing to destroy. A type with a relocate or
+// destroy hook but no copy hook cannot be copied.
+struct component_descriptor
+{
+	const char* name = nullptr;
+	uint32_t size = 0;
+	uint32_t alignment = 1;
+
+	const component_field* fields = nullptr;
+	uint32_t field_count = 0;
+
+	void (*construct)(void* value) = nullptr;
+	void (*copy)(void* dst, const void* src) = nullptr;
+	void (*relocate)(void* dst, void* src) = nullptr;
+	void (*destroy)(void* value) = nullptr;
+};
+
+// Sparse set pool for a runtime-defined component type. Shares the id side with
+// abstract_component through dense_set; values are packed contiguously with a
+// fixed stride next to their entity ids. The descriptor's name and fields are
+// copied, so it does not need to outlive the pool.
+struct runtime_component : dense_set<uint32_t>
+{
+	static constexpr size_type MAX_SIZE = MAX_ENTITY_COUNT;
+	static constexpr index_type INVALID_INDEX = dense_set::INVALID_INDEX;
+
+	explicit runtime_component(const component_descriptor& descriptor) noexcept;
+	~runtime_component() noexcept;
+
+	runtime_component(const runtime_component&) = delete;
+	runtime_component& operator=(const runtime_component&) = delete;
+
+	inline bool valid() const noexcept { return stride_ != 0; }
+	inline const component_descriptor& descriptor() const noexcept { return descriptor_; }
+	inline const char* name() const noexcept { return descriptor_.name; }
+	inline size_type stride() const noexcept { return stride_; }
+	inline bool copyable() const noexcept { return descriptor_.copy || (!descriptor_.relocate && !descriptor_.destroy); }
+
+	const component_field* find_field(const char* name) const noexcept;
+
+	void* emplace(entity_id id) noexcept;
+	void* set(entity_id id, const void* value) noexcept;
+	void touch(entity_id id) noexcept;
+
+	const void* get(entity_id id) const noexcept;
+	void* get(entity_id id) noexcept;
+	bool has(entity_id id) const noexcept;
+
+	void remove(entity_id id) noexcept;
+	void clear() noexcept;
+
+	inline void* data() noexcept { return values_; }
+	inline const void* data() const noexcept { return values_; }
+	inline void* at(index_type idx) noexcept { return values_ + size_t{ stride_ } * idx; }
+	inline const void* at(index_type idx) const noexcept { return values_ + size_t{ stride_ } * idx; }
+	inline const entity_id* ids() const noexcept { return id_of_index_; }
+
+	bool reserve(size_type capacity) noexcept;
+	void shrink_to_fit() noexcept;
+
+	size_t memory_usage() const noexcept;
+
+	void set_budget(memory_budget* budget) noexcept;
+
+	// Only between pools of the same layout: size, alignment, fields and lifetime hooks.
+	bool restore_from(const runtime_component& other) noexcept;
+	bool clone_to(runtime_component& other) const noexcept;
+
+	bool same_layout(const runtime_component& other) const noexcept;
+
+	template<typename V>
+	static inline V* field(void* value, const component_field& field) noexcept
+	{
+		return reinterpret_cast<V*>(static_cast<std::byte*>(value) + field.offset);
+	}
+
+	template<typename V>
+	static inline const V* field(const void* value, const component_field& field) noexcept
+	{
+		return reinterpret_cast<const V*>(static_cast<const std::byte*>(value) + field.offset);
+	}
+
+private:
+
+	component_descriptor descriptor_ {};
+	dynamic_array<char> names_;
+	dynamic_array<component_field> fields_;
+
+	std::byte* values_ = nullptr;
+	size_type stride_ = 0;
+
+	bool copy_descriptor_(const component_descriptor& descriptor) noexcept;
+
+	index_type find_(entity_id id) const noexcept;
+	void* insert_(entity_id id) noexcept;
+
+	void construct_(void* value) const noexcept;
+	void copy_(void* dst, const void* src) const noexcept;
+	void relocate_(void* dst, void* src) const noexcept;
+	void destroy_(void* value) const noexcept;
+
+	bool grow_(size_type required) noexcept;
+	bool reallocate_(size_type capacity) noexcept;
+
+	void* allocate_values_(size_type capacity) const noexcept;
+	void deallocate_values_(void* values) const noexcept;
+};
+
+} // namespace ecs
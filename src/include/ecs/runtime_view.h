@@ -0,0 +1,43 @@
+#pragma once
+
+#include "ecs/component_concept.h"
+#include "ecs/runtime_component.h"
+
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <tuple>
+
+namespace ecs
+{
+
+// Joins runtime-defined pools with static ones. Iteration walks the dense array
+// of the smallest runtime pool and looks the entity up in every other pool;
+// fn receives the runtime values in the order the pools were given, followed by
+// references to the static values.
+template<ecs_component... component_t>
+struct runtime_view
+{
+	using size_type = uint32_t;
+
+	static constexpr size_t MAX_RUNTIME_POOLS = 8;
+
+	runtime_view(std::initializer_list<runtime_component*> runtime_pools, component_t*... pools) noexcept;
+
+	inline bool valid() const noexcept { return valid_; }
+	inline size_type runtime_count() const noexcept { return runtime_count_; }
+
+	template<typename fn_t>
+	void each(fn_t&& fn) noexcept;
+
+private:
+
+	std::array<runtime_component*, MAX_RUNTIME_POOLS> runtime_pools_ = {};
+	std::tuple<component_t*...> pools_ = {};
+	size_type runtime_count_ = 0;
+	bool valid_ = false;
+};
+
+} // namespace ecs
+
+#include "ecs/runtime_view.hpp"
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "ecs/runtime_view.h"
+
+namespace ecs
+{
+
+template<ecs_component... component_t>
+inline runtime_view<component_t...>::runtime_view(std::initializer_list<runtime_component*> runtime_pools, component_t*... pools) noexcept
+	: pools_(pools...)
+{
+	if (runtime_pools.size() == 0 || runtime_pools.size() > MAX_RUNTIME_POOLS || ((pools == nullptr) || ...))
+	{
+		return;
+	}
+
+	for (runtime_component* pool : runtime_pools)
+	{
+		if (pool == nullptr)
+		{
+			return;
+		}
+
+		runtime_pools_[runtime_count_++] = pool;
+	}
+
+	valid_ = true;
+}
+
+template<ecs_component... component_t>
+template<typename fn_t>
+inline void runtime_view<component_t...>::each(fn_t&& fn) noexcept
+{
+	if (!valid_)
+	{
+		return;
+	}
+
+	size_type driver = 0;
+
+	for (size_type slot = 1; slot < runtime_count_; ++slot)
+	{
+		if (runtime_pools_[slot]->size() < runtime_pools_[driver]->size())
+		{
+			driver = slot;
+		}
+	}
+
+	runtime_component* first = runtime_pools_[driver];
+	void* values[MAX_RUNTIME_POOLS] = {};
+
+	std::apply([&](component_t*... pools)
+	{
+		for (size_type idx = 0; idx < first->size(); ++idx)
+		{
+			entity_id id = first->ids()[idx];
+			bool matched = true;
+
+			for (size_type slot = 0; slot < runtime_count_ && matched; ++slot)
+			{
+				values[slot] = slot == driver ? first->at(idx) : runtime_pools_[slot]->get(id);
+				matched = values[slot] != nullptr;
+			}
+
+			if (!matched || !(pools->has(id) && ...))
+			{
+				continue;
+			}
+
+			fn(id, static_cast<void* const*>(values), *pools->get(id)...);
+		}
+	},
+	pools_);
+}
+
+} // namespace ecs
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ecs/component_locator.h"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace ecs
+{
+
+// Moves the values of one trivially copyable component type between a world and
+// packed byte buffers. Internal to the containers that hold components outside a
+// world: sharded_world, world_streamer and hibernation_store.
+struct section_codec
+{
+	using size_type = uint32_t;
+
+	uint32_t value_size = 0;
+
+	// Adds the pool if the world has none. When rejected is not null, it receives
+	// 1 for every id that was not inserted and 0 for the others.
+	size_type (*insert)(component_locator&, const entity_id*, const void*, size_type, uint8_t* rejected) = nullptr;
+	// Packs the ids found in the world and their values, then removes them.
+	size_type (*extract)(component_locator&, const entity_id*, size_type, entity_id* out_ids, void* out_values) = nullptr;
+	// Packs the values found in the world with their positions in ids, leaving them in place.
+	size_type (*gather)(component_locator&, const entity_id*, size_type, uint32_t* out_slots, void* out_values) = nullptr;
+	void (*erase)(component_locator&, const entity_id*, size_type) = nullptr;
+
+	// Every instantiation has its own thunks, so insert identifies the type.
+	template<ecs_component T>
+	requires std::is_trivially_copyable_v<typename T::value_type>
+	static section_codec make() noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/section_codec.hpp"
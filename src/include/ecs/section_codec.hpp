@@ -0,0 +1,114 @@
+#pragma once
+
+#include "ecs/section_codec.h"
+
+#include <cstring>
+
+namespace ecs
+{
+
+template<ecs_component T>
+requires std::is_trivially_copyable_v<typename T::value_type>
+inline section_codec section_codec::make() noexcept
+{
+	using value_type = typename T::value_type;
+
+	section_codec codec {};
+
+	codec.value_size = static_cast<uint32_t>(sizeof(value_type));
+	codec.insert = [](component_locator& world, const entity_id* ids, const void* values, size_type count, uint8_t* rejected) -> size_type
+	{
+		T* pool = world.get<T>();
+
+		if (!pool && !(pool = world.add<T>()))
+		{
+			if (rejected)
+			{
+				std::memset(rejected, 1, count);
+			}
+
+			return 0;
+		}
+
+		size_type inserted = pool->insert(ids, static_cast<const value_type*>(values), count);
+
+		// A failed insert leaves no entry for the id, so has() tells which ones.
+		for (size_type idx = 0; rejected && idx < count; ++idx)
+		{
+			rejected[idx] = inserted < count && !pool->has(ids[idx]) ? 1 : 0;
+		}
+
+		return inserted;
+	};
+	codec.extract = [](component_locator& world, const entity_id* ids, size_type count, entity_id* out_ids, void* out_values) -> size_type
+	{
+		T* pool = world.get<T>();
+
+		if (!pool)
+		{
+			return 0;
+		}
+
+		std::byte* values = static_cast<std::byte*>(out_values);
+		size_type found = 0;
+
+		for (size_type idx = 0; idx < count; ++idx)
+		{
+			const value_type* value = pool->get(ids[idx]);
+
+			if (!value)
+			{
+				continue;
+			}
+
+			out_ids[found] = ids[idx];
+			std::memcpy(values + sizeof(value_type) * found, value, sizeof(value_type));
+			++found;
+
+			pool->remove(ids[idx]);
+		}
+
+		return found;
+	};
+	codec.gather = [](component_locator& world, const entity_id* ids, size_type count, uint32_t* out_slots, void* out_values) -> size_type
+	{
+		T* pool = world.get<T>();
+
+		if (!pool)
+		{
+			return 0;
+		}
+
+		std::byte* values = static_cast<std::byte*>(out_values);
+		size_type found = 0;
+
+		for (size_type idx = 0; idx < count; ++idx)
+		{
+			const value_type* value = pool->get(ids[idx]);
+
+			if (!value)
+			{
+				continue;
+			}
+
+			out_slots[found] = idx;
+			std::memcpy(values + sizeof(value_type) * found, value, sizeof(value_type));
+			++found;
+		}
+
+		return found;
+	};
+	codec.erase = [](component_locator& world, const entity_id* ids, size_type count)
+	{
+		T* pool = world.get<T>();
+
+		for (size_type idx = 0; pool && idx < count; ++idx)
+		{
+			pool->remove(ids[idx]);
+		}
+	};
+
+	return codec;
+}
+
+} // namespace ecs
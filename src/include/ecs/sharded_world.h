@@ -0,0 +1,187 @@
+#pragma once
+
+#include "ecs/component_locator.h"
+#include "ecs/dynamic_array.h"
+#include "ecs/event_bus.h"
+#include "ecs/section_codec.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <type_traits>
+
+namespace ecs
+{
+
+// Entities partitioned across independent locators, each ticked on its own
+// worker thread. Shards share no mutable pools: they talk through per-shard
+// message inboxes and per shard pair migration channels, both double-buffered
+// and flipped by tick() at the frame boundary while every worker is idle.
+//
+// A migration pulls an entity's registered components out of the source shard
+// during its tick and inserts them in bulk into the target shard at the start of
+// the next tick, so the entity is in flight for exactly one boundary. Components
+// of unregistered types stay behind; like the streamer, only trivially copyable
+// values can be registered.
+struct sharded_world
+{
+	using size_type = uint32_t;
+	using tick_fn = void (*)(component_locator& world, size_type shard, float delta_time, void* context);
+	using partition_fn = size_type (*)(entity_id id, size_type shard_count, void* context);
+
+	static constexpr size_type MAX_SHARDS = 64;
+
+	explicit sharded_world(size_type shard_count) noexcept;
+	~sharded_world() noexcept;
+
+	sharded_world(const sharded_world&) = delete;
+	sharded_world& operator=(const sharded_world&) = delete;
+
+	inline bool valid() const noexcept { return shards_ != nullptr; }
+	inline size_type shard_count() const noexcept { return shard_count_; }
+
+	inline component_locator& shard(size_type idx) noexcept { return shards_[idx].world; }
+	inline const component_locator& shard(size_type idx) const noexcept { return shards_[idx].world; }
+
+	// Home shard of an id. Contiguous ranges of the index space by default; a
+	// region based partition can be plugged in instead. This is only where an
+	// entity is placed initially: migrate() does not update it, so callers that
+	// move entities track their owner themselves.
+	size_type shard_of(entity_id id) const noexcept;
+	void set_partition(partition_fn fn, void* context = nullptr) noexcept;
+
+	// Registration happens before start(): message types get their inbox queues
+	// created up front, since event_bus queues must not be created concurrently.
+	template<ecs_component T>
+	requires std::is_trivially_copyable_v<typename T::value_type>
+	bool register_component() noexcept;
+
+	template<typename M>
+	requires std::is_trivially_copyable_v<M>
+	bool register_message() noexcept;
+
+	bool start();
+	void stop() noexcept;
+	inline bool running() const noexcept { return !threads_.empty(); }
+
+	void set_tick(tick_fn fn, void* context = nullptr) noexcept;
+
+	// Flips channels, then on every shard in parallel applies incoming migrations
+	// and calls the tick function. Returns once every shard is done. Without
+	// start() the shards run one after the other on the calling thread.
+	void tick(float delta_time) noexcept;
+
+	// Runs fn(shard index, locator&) on every shard in parallel and waits.
+	template<typename fn_t>
+	void run(fn_t&& fn) noexcept;
+
+	// Global query facade: fn(shard index, id, values&...) for every entity that
+	// has every component_t, shards visited in parallel through cached queries.
+	template<ecs_component... component_t, typename fn_t>
+	requires (sizeof...(component_t) > 0)
+	void each(fn_t&& fn) noexcept;
+
+	// Callable from the sender's tick; delivered at the start of the next one.
+	template<typename M>
+	requires std::is_trivially_copyable_v<M>
+	bool send(size_type to, const M& message) noexcept;
+
+	template<typename M>
+	requires std::is_trivially_copyable_v<M>
+	std::span<const M> receive(size_type shard) const noexcept;
+
+	// Called on the thread ticking shard from. Returns the number of components
+	// queued; components whose section could not be queued stay in the source.
+	size_type migrate(size_type from, size_type to, const entity_id* ids, size_type count) noexcept;
+
+	// Components left behind because a channel could not grow, plus migrated
+	// components the target shard failed to insert, which are lost.
+	inline size_type failed() const noexcept { return failed_.load(std::memory_order_relaxed); }
+
+private:
+
+	// Byte stream of sections, each a _section_header, the ids and the values, all
+	// starting on a max_align_t boundary so values can be inserted in place.
+	struct _stream
+	{
+		dynamic_array<std::max_align_t> data;
+		size_t size = 0;
+	};
+
+	struct _section_header
+	{
+		uint32_t codec;
+		size_type count;
+	};
+
+	struct _channel
+	{
+		_stream write;
+		_stream read;
+	};
+
+	struct _shard
+	{
+		component_locator world;
+		event_bus inbox;
+
+		// Scratch for migrate(), only touched by the shard's own thread.
+		dynamic_array<entity_id> ids;
+		dynamic_array<std::max_align_t> values;
+	};
+
+	struct _job
+	{
+		void (*run)(void* context, sharded_world& world, size_type shard) = nullptr;
+		void* context = nullptr;
+	};
+
+	static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+
+	_shard* shards_ = nullptr;
+	size_type shard_count_ = 0;
+
+	// shard_count_ * shard_count_ entries, indexed by from * shard_count_ + to.
+	_channel* channels_ = nullptr;
+
+	dynamic_array<section_codec> codecs_;
+
+	partition_fn partition_ = nullptr;
+	void* partition_context_ = nullptr;
+
+	tick_fn tick_ = nullptr;
+	void* tick_context_ = nullptr;
+	float delta_time_ = 0.0f;
+
+	dynamic_array<std::thread> threads_;
+
+	std::mutex mutex_;
+	std::condition_variable wake_;
+	std::condition_variable done_;
+
+	_job job_;
+	uint64_t generation_ = 0;
+	std::atomic<size_type> remaining_ = 0;
+	bool stopping_ = false;
+
+	std::atomic<size_type> failed_ = 0;
+
+	void dispatch_(_job job) noexcept;
+	void worker_(size_type shard, uint64_t generation) noexcept;
+
+	void flip_() noexcept;
+	void apply_migrations_(size_type shard) noexcept;
+
+	static bool reserve_(_stream& stream, size_t size) noexcept;
+	static size_t align_(size_t size) noexcept { return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+	static std::byte* bytes_(_stream& stream) noexcept { return reinterpret_cast<std::byte*>(stream.data.data()); }
+	static size_type default_partition_(entity_id id, size_type shard_count, void* context) noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/sharded_world.hpp"
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "ecs/sharded_world.h"
+
+#include <memory>
+
+namespace ecs
+{
+
+template<ecs_component T>
+requires std::is_trivially_copyable_v<typename T::value_type>
+inline bool sharded_world::register_component() noexcept
+{
+	using value_type = typename T::value_type;
+
+	// Values are inserted straight from the channel, where they start on an
+	// ALIGNMENT boundary.
+	static_assert(alignof(value_type) <= ALIGNMENT, "migration channels do not honour over-aligned components");
+
+	section_codec codec = section_codec::make<T>();
+
+	for (const section_codec& registered : codecs_)
+	{
+		if (registered.insert == codec.insert)
+		{
+			return false;
+		}
+	}
+
+	return !running() && codecs_.emplace_back(codec) != nullptr;
+}
+
+template<typename M>
+requires std::is_trivially_copyable_v<M>
+inline bool sharded_world::register_message() noexcept
+{
+	if (running())
+	{
+		return false;
+	}
+
+	for (size_type idx = 0; idx < shard_count_; ++idx)
+	{
+		if (!shards_[idx].inbox.queue<M>())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+template<typename fn_t>
+inline void sharded_world::run(fn_t&& fn) noexcept
+{
+	_job job {};
+
+	job.context = static_cast<void*>(std::addressof(fn));
+	job.run = [](void* context, sharded_world& world, size_type shard)
+	{
+		(*static_cast<std::remove_reference_t<fn_t>*>(context))(shard, world.shard(shard));
+	};
+
+	dispatch_(job);
+}
+
+template<ecs_component... component_t, typename fn_t>
+requires (sizeof...(component_t) > 0)
+inline void sharded_world::each(fn_t&& fn) noexcept
+{
+	run([&fn](size_type shard, component_locator& world)
+	{
+		cached_query<component_t...>* query = world.query<component_t...>();
+
+		if (!query)
+		{
+			return;
+		}
+
+		query->each([&fn, shard](entity_id id, typename component_t::value_type&... values)
+		{
+			fn(shard, id, values...);
+		});
+	});
+}
+
+template<typename M>
+requires std::is_trivially_copyable_v<M>
+inline bool sharded_world::send(size_type to, const M& message) noexcept
+{
+	if (to >= shard_count_)
+	{
+		return false;
+	}
+
+	return shards_[to].inbox.emit(message) != nullptr;
+}
+
+template<typename M>
+requires std::is_trivially_copyable_v<M>
+inline std::span<const M> sharded_world::receive(size_type shard) const noexcept
+{
+	if (shard >= shard_count_)
+	{
+		return {};
+	}
+
+	return shards_[shard].inbox.read<M>();
+}
+
+} // namespace ecs
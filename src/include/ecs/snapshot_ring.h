@@ -0,0 +1,50 @@
+#pragma once
+
+#include "ecs/component_locator.h"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+
+namespace ecs
+{
+
+// Fixed ring of world snapshots keyed by frame number, for rollback. Every slot is
+// a full locator whose pools keep their capacity between saves, so once warmed up
+// by prepare() saving and restoring only copy memory.
+template<size_t N>
+requires (N > 0)
+struct snapshot_ring
+{
+	using frame_type = uint64_t;
+
+	static constexpr size_t CAPACITY = N;
+	static constexpr frame_type INVALID_FRAME = std::numeric_limits<frame_type>::max();
+
+	snapshot_ring() noexcept;
+
+	snapshot_ring(const snapshot_ring&) = delete;
+	snapshot_ring& operator=(const snapshot_ring&) = delete;
+
+	bool prepare(const component_locator& world) noexcept;
+
+	bool save(const component_locator& world, frame_type frame) noexcept;
+	bool restore(component_locator& world, frame_type frame) const noexcept;
+
+	bool contains(frame_type frame) const noexcept;
+	const component_locator* find(frame_type frame) const noexcept;
+
+	void invalidate_after(frame_type frame) noexcept;
+	void invalidate() noexcept;
+
+private:
+
+	std::array<component_locator, N> slots_;
+	std::array<frame_type, N> frames_;
+
+	static constexpr size_t slot_of_(frame_type frame) noexcept { return static_cast<size_t>(frame % N); }
+};
+
+} // namespace ecs
+
+#include "ecs/snapshot_ring.hpp"
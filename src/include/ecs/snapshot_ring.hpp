@@ -0,0 +1,105 @@
+#pragma once
+
+#include "ecs/snapshot_ring.h"
+
+namespace ecs
+{
+
+template<size_t N>
+requires (N > 0)
+inline snapshot_ring<N>::snapshot_ring() noexcept
+{
+	frames_.fill(INVALID_FRAME);
+}
+
+template<size_t N>
+requires (N > 0)
+inline bool snapshot_ring<N>::prepare(const component_locator& world) noexcept
+{
+	bool prepared = true;
+
+	for (component_locator& slot : slots_)
+	{
+		prepared = slot.restore_from(world) && prepared;
+	}
+
+	invalidate();
+
+	return prepared;
+}
+
+template<size_t N>
+requires (N > 0)
+inline bool snapshot_ring<N>::save(const component_locator& world, frame_type frame) noexcept
+{
+	if (frame == INVALID_FRAME)
+	{
+		return false;
+	}
+
+	size_t slot = slot_of_(frame);
+
+	if (!slots_[slot].restore_from(world))
+	{
+		frames_[slot] = INVALID_FRAME;
+		return false;
+	}
+
+	frames_[slot] = frame;
+	return true;
+}
+
+template<size_t N>
+requires (N > 0)
+inline bool snapshot_ring<N>::restore(component_locator& world, frame_type frame) const noexcept
+{
+	const component_locator* snapshot = find(frame);
+
+	if (!snapshot)
+	{
+		return false;
+	}
+
+	return world.restore_from(*snapshot);
+}
+
+template<size_t N>
+requires (N > 0)
+inline bool snapshot_ring<N>::contains(frame_type frame) const noexcept
+{
+	return frame != INVALID_FRAME && frames_[slot_of_(frame)] == frame;
+}
+
+template<size_t N>
+requires (N > 0)
+inline const component_locator* snapshot_ring<N>::find(frame_type frame) const noexcept
+{
+	if (!contains(frame))
+	{
+		return nullptr;
+	}
+
+	return &slots_[slot_of_(frame)];
+}
+
+template<size_t N>
+requires (N > 0)
+inline void snapshot_ring<N>::invalidate_after(frame_type frame) noexcept
+{
+	for (frame_type& saved : frames_)
+	{
+		if (saved != INVALID_FRAME && saved > frame)
+		{
+			saved = INVALID_FRAME;
+		}
+	}
+}
+
+template<size_t N>
+requires (N > 0)
+inline void snapshot_ring<N>::invalidate() noexcept
+{
+	frames_.fill(INVALID_FRAME);
+}
+
+} // namespace ecs
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "ecs/dynamic_array.h"
+#include "ecs/entity_id.h"
+#include "ecs/memory_budget.h"
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+namespace ecs
+{
+
+// Paged entity -> dense index map, keyed by the index part of the id. Pages are
+// allocated on first use and can be released once empty; the page directory only
+// grows up to the highest page touched, so a pool only pays for the id ranges it
+// actually uses even when the index space spans tens of millions of entities.
+template<typename index_t>
+struct sparse_index
+{
+	using index_type = index_t;
+	using size_type = uint32_t;
+
+	static constexpr index_type INVALID_INDEX = std::numeric_limits<index_type>::max();
+	static constexpr size_type PAGE_SIZE = 4096;
+	static constexpr size_type MAX_PAGE_COUNT = static_cast<size_type>((MAX_ENTITY_COUNT + PAGE_SIZE - 1) / PAGE_SIZE);
+	static constexpr size_t PAGE_BYTES = sizeof(index_type) * PAGE_SIZE;
+
+	sparse_index() noexcept = default;
+	~sparse_index() noexcept;
+
+	sparse_index(const sparse_index&) = delete;
+	sparse_index& operator=(const sparse_index&) = delete;
+
+	index_type find(entity_id id) const noexcept;
+	index_type find_unchecked(entity_id id) const noexcept;
+
+	bool acquire(entity_id id, memory_budget* budget) noexcept;
+	void set(entity_id id, index_type idx) noexcept;
+	void reset(entity_id id) noexcept;
+
+	bool copy_from(const sparse_index& other, memory_budget* budget) noexcept;
+	void clear() noexcept;
+
+	size_t shrink_to_fit() noexcept;
+
+	inline size_type page_count() const noexcept { return allocated_pages_; }
+	inline size_t memory_usage() const noexcept { return PAGE_BYTES * allocated_pages_ + DIRECTORY_BYTES_PER_PAGE * pages_.capacity(); }
+
+private:
+
+	static constexpr size_t DIRECTORY_BYTES_PER_PAGE = sizeof(index_type*) + sizeof(size_type) + sizeof(uint64_t);
+
+	dynamic_array<index_type*> pages_;
+	dynamic_array<size_type> counts_;
+
+	// Content tag per page for copy_from: pages carrying the same non-zero tag hold
+	// identical entries, zero means modified since the last copy.
+	mutable dynamic_array<uint64_t> versions_;
+
+	static inline std::atomic<uint64_t> next_version_ = 1;
+
+	size_type allocated_pages_ = 0;
+
+	bool acquire_page_(size_type page, memory_budget* budget) noexcept;
+	bool grow_directory_(size_type page_count, memory_budget* budget) noexcept;
+
+	static constexpr size_type page_of_(entity_id id) noexcept { return entity_index(id) / PAGE_SIZE; }
+	static constexpr size_type offset_of_(entity_id id) noexcept { return entity_index(id) % PAGE_SIZE; }
+};
+
+} // namespace ecs
+
+#include "ecs/sparse_index.hpp"
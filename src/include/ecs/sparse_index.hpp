@@ -0,0 +1,258 @@
+#pragma once
+
+#include "ecs/sparse_index.h"
+#include "ecs/default_allocator.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace ecs
+{
+
+template<typename index_t>
+inline sparse_index<index_t>::~sparse_index() noexcept
+{
+	for (index_type* page : pages_)
+	{
+		if (page)
+		{
+			default_allocator<index_type>{}.deallocate(page, PAGE_SIZE);
+		}
+	}
+}
+
+template<typename index_t>
+inline sparse_index<index_t>::index_type sparse_index<index_t>::find(entity_id id) const noexcept
+{
+	size_type page_index = page_of_(id);
+
+	if (page_index >= pages_.size())
+	{
+		return INVALID_INDEX;
+	}
+
+	const index_type* page = pages_[page_index];
+
+	if (!page)
+	{
+		return INVALID_INDEX;
+	}
+
+	return page[offset_of_(id)];
+}
+
+template<typename index_t>
+inline sparse_index<index_t>::index_type sparse_index<index_t>::find_unchecked(entity_id id) const noexcept
+{
+	return pages_[page_of_(id)][offset_of_(id)];
+}
+
+template<typename index_t>
+inline bool sparse_index<index_t>::acquire(entity_id id, memory_budget* budget) noexcept
+{
+	return acquire_page_(page_of_(id), budget);
+}
+
+template<typename index_t>
+inline void sparse_index<index_t>::set(entity_id id, index_type idx) noexcept
+{
+	size_type page = page_of_(id);
+	index_type& entry = pages_[page][offset_of_(id)];
+
+	if (entry == INVALID_INDEX)
+	{
+		++counts_[page];
+	}
+
+	entry = idx;
+	versions_[page] = 0;
+}
+
+template<typename index_t>
+inline void sparse_index<index_t>::reset(entity_id id) noexcept
+{
+	size_type page = page_of_(id);
+
+	if (page >= pages_.size() || !pages_[page])
+	{
+		return;
+	}
+
+	index_type& entry = pages_[page][offset_of_(id)];
+
+	if (entry != INVALID_INDEX)
+	{
+		--counts_[page];
+		entry = INVALID_INDEX;
+		versions_[page] = 0;
+	}
+}
+
+template<typename index_t>
+inline bool sparse_index<index_t>::copy_from(const sparse_index& other, memory_budget* budget) noexcept
+{
+	size_type page_count = static_cast<size_type>(std::max(pages_.size(), other.pages_.size()));
+
+	for (size_type page = 0; page < page_count; ++page)
+	{
+		if (page < other.pages_.size() && other.pages_[page])
+		{
+			if (!acquire_page_(page, budget))
+			{
+				return false;
+			}
+
+			if (other.versions_[page] == 0)
+			{
+				other.versions_[page] = next_version_.fetch_add(1, std::memory_order_relaxed);
+			}
+			else if (versions_[page] == other.versions_[page])
+			{
+				continue;
+			}
+
+			std::memcpy(pages_[page], other.pages_[page], PAGE_BYTES);
+			versions_[page] = other.versions_[page];
+		}
+		else
+		{
+			// other has no page here; past the end of this directory there is
+			// nothing to clear either.
+			if (page < pages_.size())
+			{
+				if (pages_[page] && counts_[page] > 0)
+				{
+					std::fill_n(pages_[page], PAGE_SIZE, INVALID_INDEX);
+					versions_[page] = 0;
+				}
+
+				counts_[page] = 0;
+			}
+
+			continue;
+		}
+
+		counts_[page] = other.counts_[page];
+	}
+
+	return true;
+}
+
+template<typename index_t>
+inline void sparse_index<index_t>::clear() noexcept
+{
+	for (size_type page = 0; page < pages_.size(); ++page)
+	{
+		if (pages_[page] && counts_[page] > 0)
+		{
+			std::fill_n(pages_[page], PAGE_SIZE, INVALID_INDEX);
+			versions_[page] = 0;
+		}
+
+		counts_[page] = 0;
+	}
+}
+
+template<typename index_t>
+inline size_t sparse_index<index_t>::shrink_to_fit() noexcept
+{
+	size_t released = 0;
+
+	for (size_type page = 0; page < pages_.size(); ++page)
+	{
+		if (pages_[page] && counts_[page] == 0)
+		{
+			default_allocator<index_type>{}.deallocate(pages_[page], PAGE_SIZE);
+			pages_[page] = nullptr;
+			versions_[page] = 0;
+
+			--allocated_pages_;
+			released += PAGE_BYTES;
+		}
+	}
+
+	// Trailing empty directory entries go too.
+	size_t directory = pages_.capacity();
+
+	while (!pages_.empty() && !pages_.back())
+	{
+		pages_.pop_back();
+		counts_.pop_back();
+		versions_.pop_back();
+	}
+
+	pages_.shrink_to_fit();
+	counts_.shrink_to_fit();
+	versions_.shrink_to_fit();
+
+	released += DIRECTORY_BYTES_PER_PAGE * (directory - pages_.capacity());
+
+	return released;
+}
+
+template<typename index_t>
+inline bool sparse_index<index_t>::acquire_page_(size_type page, memory_budget* budget) noexcept
+{
+	if (page >= pages_.size() && !grow_directory_(page + 1, budget))
+	{
+		return false;
+	}
+
+	if (pages_[page])
+	{
+		return true;
+	}
+
+	if (budget && !budget->try_acquire(PAGE_BYTES))
+	{
+		return false;
+	}
+
+	pages_[page] = default_allocator<index_type>{}.allocate(PAGE_SIZE);
+
+	if (!pages_[page])
+	{
+		if (budget)
+		{
+			budget->release(PAGE_BYTES);
+		}
+
+		return false;
+	}
+
+	std::fill_n(pages_[page], PAGE_SIZE, INVALID_INDEX);
+	++allocated_pages_;
+
+	return true;
+}
+
+template<typename index_t>
+inline bool sparse_index<index_t>::grow_directory_(size_type page_count, memory_budget* budget) noexcept
+{
+	if (page_count > MAX_PAGE_COUNT)
+	{
+		return false;
+	}
+
+	size_t size = pages_.size();
+	size_t capacity = pages_.capacity();
+
+	// Directory entries are small next to the pages they point at, so their growth
+	// is charged to the budget without being able to fail on it.
+	if (!pages_.resize(page_count) || !counts_.resize(page_count) || !versions_.resize(page_count))
+	{
+		pages_.resize(size);
+		counts_.resize(size);
+		versions_.resize(size);
+		return false;
+	}
+
+	if (budget && pages_.capacity() > capacity)
+	{
+		budget->charge(DIRECTORY_BYTES_PER_PAGE * (pages_.capacity() - capacity));
+	}
+
+	return true;
+}
+
+} // namespace ecs
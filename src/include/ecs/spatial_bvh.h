@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ecs/spatial_index.h"
+#include "ecs/dynamic_array.h"
+
+#include <cstdint>
+
+namespace ecs
+{
+
+// Bounding volume hierarchy over the positions of a pool, rebuilt in one batch
+// from its dense array. Suits sparse or strongly clustered layouts where a uniform
+// grid either wastes cells or degenerates into a few crowded ones.
+template<ecs_component T, typename position_fn = xy_position>
+requires spatial_position_fn<position_fn, T>
+struct spatial_bvh
+{
+	using size_type = uint32_t;
+
+	static constexpr size_type LEAF_SIZE = 8;
+	static constexpr size_type MAX_DEPTH = 64;
+
+	spatial_bvh() noexcept = default;
+
+	spatial_bvh(const spatial_bvh&) = delete;
+	spatial_bvh& operator=(const spatial_bvh&) = delete;
+
+	void bind(const T* pool) noexcept;
+
+	bool rebuild() noexcept;
+
+	template<typename fn_t>
+	void query_radius(spatial_point center, float radius, fn_t&& fn) const noexcept;
+
+	template<typename fn_t>
+	void query_box(const spatial_box& box, fn_t&& fn) const noexcept;
+
+	size_type query_radius(spatial_point center, float radius, dynamic_array<entity_id>& out) const noexcept;
+	size_type query_box(const spatial_box& box, dynamic_array<entity_id>& out) const noexcept;
+
+	inline size_type size() const noexcept { return static_cast<size_type>(items_.size()); }
+	inline bool empty() const noexcept { return items_.empty(); }
+
+private:
+
+	struct _item
+	{
+		spatial_point position;
+		entity_id id = INVALID_ENTITY_ID;
+	};
+
+	struct _node
+	{
+		spatial_box box;
+		size_type first = 0;
+		size_type count = 0;
+	};
+
+	const T* pool_ = nullptr;
+
+	dynamic_array<_item> items_;
+	dynamic_array<_node> nodes_;
+	dynamic_array<size_type> pending_;
+
+	template<typename test_t, typename fn_t>
+	void traverse_(const spatial_box& box, test_t&& test, fn_t&& fn) const noexcept;
+
+	spatial_box bounds_of_(size_type first, size_type count) const noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/spatial_bvh.hpp"
@@ -0,0 +1,225 @@
+#pragma once
+
+#include "ecs/spatial_bvh.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace ecs
+{
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline void spatial_bvh<T, position_fn>::bind(const T* pool) noexcept
+{
+	pool_ = pool;
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline bool spatial_bvh<T, position_fn>::rebuild() noexcept
+{
+	size_type count = pool_ ? pool_->size() : 0;
+
+	nodes_.clear();
+	pending_.clear();
+
+	if (!items_.resize(count))
+	{
+		items_.clear();
+		return false;
+	}
+
+	position_fn position_of {};
+
+	auto values = pool_ ? pool_->begin() : nullptr;
+	size_type kept = 0;
+
+	// As in spatial_grid, positions that are not finite would poison the bounds
+	// and the median splits; they are left out of the tree.
+	for (size_type idx = 0; idx < count; ++idx)
+	{
+		spatial_point p = position_of(values[idx]);
+
+		if (!std::isfinite(p.x) || !std::isfinite(p.y))
+		{
+			continue;
+		}
+
+		items_[kept++] = { p, pool_->get_id(idx) };
+	}
+
+	count = kept;
+	items_.resize(count);
+
+	if (count == 0)
+	{
+		return true;
+	}
+
+	if (!nodes_.emplace_back(_node{ bounds_of_(0, count), 0, count }) || !pending_.emplace_back(0u))
+	{
+		items_.clear();
+		return false;
+	}
+
+	while (!pending_.empty())
+	{
+		size_type node_idx = pending_.back();
+		pending_.pop_back();
+
+		_node node = nodes_[node_idx];
+
+		if (node.count <= LEAF_SIZE)
+		{
+			continue;
+		}
+
+		bool split_x = node.box.max.x - node.box.min.x >= node.box.max.y - node.box.min.y;
+		size_type half = node.count / 2;
+
+		auto first = items_.begin() + node.first;
+		std::nth_element(first, first + half, first + node.count, [split_x](const _item& a, const _item& b)
+		{
+			return split_x ? a.position.x < b.position.x : a.position.y < b.position.y;
+		});
+
+		size_type left = static_cast<size_type>(nodes_.size());
+
+		if (!nodes_.emplace_back(_node{ bounds_of_(node.first, half), node.first, half })
+			|| !nodes_.emplace_back(_node{ bounds_of_(node.first + half, node.count - half), node.first + half, node.count - half })
+			|| !pending_.emplace_back(left)
+			|| !pending_.emplace_back(left + 1))
+		{
+			items_.clear();
+			nodes_.clear();
+			return false;
+		}
+
+		nodes_[node_idx].first = left;
+		nodes_[node_idx].count = 0;
+	}
+
+	return true;
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+template<typename fn_t>
+inline void spatial_bvh<T, position_fn>::query_radius(spatial_point center, float radius, fn_t&& fn) const noexcept
+{
+	float radius_sq = radius * radius;
+	spatial_box box { { center.x - radius, center.y - radius }, { center.x + radius, center.y + radius } };
+
+	traverse_(box, [center, radius_sq](spatial_point p)
+	{
+		float dx = p.x - center.x;
+		float dy = p.y - center.y;
+		return dx * dx + dy * dy <= radius_sq;
+	},
+	fn);
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+template<typename fn_t>
+inline void spatial_bvh<T, position_fn>::query_box(const spatial_box& box, fn_t&& fn) const noexcept
+{
+	traverse_(box, [&box](spatial_point p)
+	{
+		return box.contains(p);
+	},
+	fn);
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline spatial_bvh<T, position_fn>::size_type spatial_bvh<T, position_fn>::query_radius(spatial_point center, float radius, dynamic_array<entity_id>& out) const noexcept
+{
+	size_type found = 0;
+
+	query_radius(center, radius, [&out, &found](entity_id id)
+	{
+		found += out.emplace_back(id) ? 1 : 0;
+	});
+
+	return found;
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline spatial_bvh<T, position_fn>::size_type spatial_bvh<T, position_fn>::query_box(const spatial_box& box, dynamic_array<entity_id>& out) const noexcept
+{
+	size_type found = 0;
+
+	query_box(box, [&out, &found](entity_id id)
+	{
+		found += out.emplace_back(id) ? 1 : 0;
+	});
+
+	return found;
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+template<typename test_t, typename fn_t>
+inline void spatial_bvh<T, position_fn>::traverse_(const spatial_box& box, test_t&& test, fn_t&& fn) const noexcept
+{
+	if (nodes_.empty())
+	{
+		return;
+	}
+
+	std::array<size_type, MAX_DEPTH * 2> stack;
+	size_type top = 0;
+
+	stack[top++] = 0;
+
+	while (top > 0)
+	{
+		const _node& node = nodes_[stack[--top]];
+
+		if (!node.box.intersects(box))
+		{
+			continue;
+		}
+
+		if (node.count > 0)
+		{
+			for (size_type idx = node.first; idx < node.first + node.count; ++idx)
+			{
+				if (test(items_[idx].position))
+				{
+					fn(items_[idx].id);
+				}
+			}
+		}
+		else
+		{
+			stack[top++] = node.first;
+			stack[top++] = node.first + 1;
+		}
+	}
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline spatial_box spatial_bvh<T, position_fn>::bounds_of_(size_type first, size_type count) const noexcept
+{
+	spatial_box box { items_[first].position, items_[first].position };
+
+	for (size_type idx = first + 1; idx < first + count; ++idx)
+	{
+		const spatial_point& p = items_[idx].position;
+
+		box.min.x = std::min(box.min.x, p.x);
+		box.min.y = std::min(box.min.y, p.y);
+		box.max.x = std::max(box.max.x, p.x);
+		box.max.y = std::max(box.max.y, p.y);
+	}
+
+	return box;
+}
+
+} // namespace ecs
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "ecs/spatial_index.h"
+#include "ecs/dynamic_array.h"
+
+#include <cstdint>
+
+namespace ecs
+{
+
+// Uniform grid over the positions of a pool, rebuilt in bulk from its dense array.
+// Items are bucketed by a counting sort, so every cell is a contiguous run of
+// positions and ids. Entities with non-finite positions are not indexed.
+template<ecs_component T, typename position_fn = xy_position>
+requires spatial_position_fn<position_fn, T>
+struct spatial_grid
+{
+	using size_type = uint32_t;
+
+	static constexpr size_type MIN_CELL_COUNT = 1024;
+
+	explicit spatial_grid(float cell_size = 1.0f) noexcept;
+
+	spatial_grid(const spatial_grid&) = delete;
+	spatial_grid& operator=(const spatial_grid&) = delete;
+
+	void bind(const T* pool) noexcept;
+	void set_cell_size(float cell_size) noexcept;
+
+	bool rebuild() noexcept;
+
+	template<typename fn_t>
+	void query_radius(spatial_point center, float radius, fn_t&& fn) const noexcept;
+
+	template<typename fn_t>
+	void query_box(const spatial_box& box, fn_t&& fn) const noexcept;
+
+	size_type query_radius(spatial_point center, float radius, dynamic_array<entity_id>& out) const noexcept;
+	size_type query_box(const spatial_box& box, dynamic_array<entity_id>& out) const noexcept;
+
+	inline size_type size() const noexcept { return static_cast<size_type>(ids_.size()); }
+	inline bool empty() const noexcept { return ids_.empty(); }
+	inline const spatial_box& bounds() const noexcept { return bounds_; }
+
+private:
+
+	const T* pool_ = nullptr;
+
+	float cell_size_ = 1.0f;
+	float inv_cell_size_ = 1.0f;
+
+	spatial_box bounds_ = {};
+	size_type columns_ = 0;
+	size_type rows_ = 0;
+
+	dynamic_array<size_type> cell_start_;
+	dynamic_array<size_type> item_cell_;
+	dynamic_array<spatial_point> scratch_;
+	dynamic_array<entity_id> scratch_ids_;
+	dynamic_array<spatial_point> points_;
+	dynamic_array<entity_id> ids_;
+
+	size_type column_of_(float x) const noexcept;
+	size_type row_of_(float y) const noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/spatial_grid.hpp"
@@ -0,0 +1,294 @@
+#pragma once
+
+#include "ecs/spatial_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ecs
+{
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline spatial_grid<T, position_fn>::spatial_grid(float cell_size) noexcept
+{
+	set_cell_size(cell_size);
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline void spatial_grid<T, position_fn>::bind(const T* pool) noexcept
+{
+	pool_ = pool;
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline void spatial_grid<T, position_fn>::set_cell_size(float cell_size) noexcept
+{
+	cell_size_ = cell_size > 0.0f ? cell_size : 1.0f;
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline bool spatial_grid<T, position_fn>::rebuild() noexcept
+{
+	size_type count = pool_ ? pool_->size() : 0;
+
+	if (!scratch_.resize(count) || !scratch_ids_.resize(count))
+	{
+		ids_.clear();
+		columns_ = rows_ = 0;
+		return false;
+	}
+
+	position_fn position_of {};
+
+	auto values = pool_ ? pool_->begin() : nullptr;
+	spatial_box bounds {};
+	size_type kept = 0;
+
+	// Positions that are not finite would poison the bounds and cannot be bucketed;
+	// they are left out of the grid.
+	for (size_type idx = 0; idx < count; ++idx)
+	{
+		spatial_point p = position_of(values[idx]);
+
+		if (!std::isfinite(p.x) || !std::isfinite(p.y))
+		{
+			continue;
+		}
+
+		if (kept == 0)
+		{
+			bounds = { p, p };
+		}
+
+		scratch_[kept] = p;
+		scratch_ids_[kept] = pool_->get_id(idx);
+		++kept;
+
+		bounds.min.x = std::min(bounds.min.x, p.x);
+		bounds.min.y = std::min(bounds.min.y, p.y);
+		bounds.max.x = std::max(bounds.max.x, p.x);
+		bounds.max.y = std::max(bounds.max.y, p.y);
+	}
+
+	count = kept;
+
+	if (!item_cell_.resize(count) || !points_.resize(count) || !ids_.resize(count))
+	{
+		ids_.clear();
+		columns_ = rows_ = 0;
+		return false;
+	}
+
+	if (count == 0)
+	{
+		columns_ = rows_ = 0;
+		bounds_ = {};
+		return cell_start_.resize(1);
+	}
+
+	bounds_ = bounds;
+
+	// In double: the extent of finite floats can still overflow a float.
+	double width = double{ bounds.max.x } - bounds.min.x;
+	double height = double{ bounds.max.y } - bounds.min.y;
+	double max_cells = static_cast<double>(std::max<uint64_t>(MIN_CELL_COUNT, uint64_t{ count } * 2));
+	double cell_size = cell_size_;
+
+	// Largest 1 / cell_size with (width / cell_size + 1) * (height / cell_size + 1)
+	// <= max_cells, so a long thin world is capped per axis as well.
+	if ((width / cell_size + 1.0) * (height / cell_size + 1.0) > max_cells)
+	{
+		double inv = width * height > 0.0
+			? (std::sqrt((width + height) * (width + height) + 4.0 * width * height * (max_cells - 1.0)) - (width + height)) / (2.0 * width * height)
+			: (max_cells - 1.0) / (width + height);
+
+		cell_size = std::max(cell_size, 1.0 / inv);
+	}
+
+	uint64_t columns = static_cast<uint64_t>(width / cell_size) + 1;
+	uint64_t rows = static_cast<uint64_t>(height / cell_size) + 1;
+	uint64_t cells = columns * rows;
+
+	if (cells >= std::numeric_limits<size_type>::max() || !cell_start_.resize(static_cast<size_type>(cells) + 1))
+	{
+		ids_.clear();
+		columns_ = rows_ = 0;
+		return false;
+	}
+
+	inv_cell_size_ = static_cast<float>(1.0 / cell_size);
+	columns_ = static_cast<size_type>(columns);
+	rows_ = static_cast<size_type>(rows);
+
+	size_type cell_count = static_cast<size_type>(cells);
+
+	std::fill(cell_start_.begin(), cell_start_.end(), 0u);
+
+	for (size_type idx = 0; idx < count; ++idx)
+	{
+		size_type cell = row_of_(scratch_[idx].y) * columns_ + column_of_(scratch_[idx].x);
+		item_cell_[idx] = cell;
+		++cell_start_[cell];
+	}
+
+	size_type offset = 0;
+	for (size_type cell = 0; cell < cell_count; ++cell)
+	{
+		size_type n = cell_start_[cell];
+		cell_start_[cell] = offset;
+		offset += n;
+	}
+
+	for (size_type idx = 0; idx < count; ++idx)
+	{
+		size_type slot = cell_start_[item_cell_[idx]]++;
+		points_[slot] = scratch_[idx];
+		ids_[slot] = scratch_ids_[idx];
+	}
+
+	for (size_type cell = cell_count; cell > 0; --cell)
+	{
+		cell_start_[cell] = cell_start_[cell - 1];
+	}
+
+	cell_start_[0] = 0;
+
+	return true;
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+template<typename fn_t>
+inline void spatial_grid<T, position_fn>::query_radius(spatial_point center, float radius, fn_t&& fn) const noexcept
+{
+	float radius_sq = radius * radius;
+	spatial_box box { { center.x - radius, center.y - radius }, { center.x + radius, center.y + radius } };
+
+	if (empty() || !box.intersects(bounds_))
+	{
+		return;
+	}
+
+	size_type first_column = column_of_(box.min.x);
+	size_type last_column = column_of_(box.max.x);
+	size_type last_row = row_of_(box.max.y);
+
+	for (size_type row = row_of_(box.min.y); row <= last_row; ++row)
+	{
+		size_type first = cell_start_[row * columns_ + first_column];
+		size_type last = cell_start_[row * columns_ + last_column + 1];
+
+		for (size_type slot = first; slot < last; ++slot)
+		{
+			float dx = points_[slot].x - center.x;
+			float dy = points_[slot].y - center.y;
+
+			if (dx * dx + dy * dy <= radius_sq)
+			{
+				fn(ids_[slot]);
+			}
+		}
+	}
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+template<typename fn_t>
+inline void spatial_grid<T, position_fn>::query_box(const spatial_box& box, fn_t&& fn) const noexcept
+{
+	if (empty() || !box.intersects(bounds_))
+	{
+		return;
+	}
+
+	size_type first_column = column_of_(box.min.x);
+	size_type last_column = column_of_(box.max.x);
+	size_type last_row = row_of_(box.max.y);
+
+	for (size_type row = row_of_(box.min.y); row <= last_row; ++row)
+	{
+		size_type first = cell_start_[row * columns_ + first_column];
+		size_type last = cell_start_[row * columns_ + last_column + 1];
+
+		for (size_type slot = first; slot < last; ++slot)
+		{
+			if (box.contains(points_[slot]))
+			{
+				fn(ids_[slot]);
+			}
+		}
+	}
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline spatial_grid<T, position_fn>::size_type spatial_grid<T, position_fn>::query_radius(spatial_point center, float radius, dynamic_array<entity_id>& out) const noexcept
+{
+	size_type found = 0;
+
+	query_radius(center, radius, [&out, &found](entity_id id)
+	{
+		found += out.emplace_back(id) ? 1 : 0;
+	});
+
+	return found;
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline spatial_grid<T, position_fn>::size_type spatial_grid<T, position_fn>::query_box(const spatial_box& box, dynamic_array<entity_id>& out) const noexcept
+{
+	size_type found = 0;
+
+	query_box(box, [&out, &found](entity_id id)
+	{
+		found += out.emplace_back(id) ? 1 : 0;
+	});
+
+	return found;
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline spatial_grid<T, position_fn>::size_type spatial_grid<T, position_fn>::column_of_(float x) const noexcept
+{
+	float column = (x - bounds_.min.x) * inv_cell_size_;
+
+	if (!(column > 0.0f))
+	{
+		return 0;
+	}
+
+	if (column >= static_cast<float>(columns_))
+	{
+		return columns_ - 1;
+	}
+
+	return static_cast<size_type>(column);
+}
+
+template<ecs_component T, typename position_fn>
+requires spatial_position_fn<position_fn, T>
+inline spatial_grid<T, position_fn>::size_type spatial_grid<T, position_fn>::row_of_(float y) const noexcept
+{
+	float row = (y - bounds_.min.y) * inv_cell_size_;
+
+	if (!(row > 0.0f))
+	{
+		return 0;
+	}
+
+	if (row >= static_cast<float>(rows_))
+	{
+		return rows_ - 1;
+	}
+
+	return static_cast<size_type>(row);
+}
+
+} // namespace ecs
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "ecs/component_concept.h"
+
+#include <concepts>
+
+namespace ecs
+{
+
+struct spatial_point
+{
+	float x = 0.0f;
+	float y = 0.0f;
+};
+
+struct spatial_box
+{
+	spatial_point min;
+	spatial_point max;
+
+	inline bool contains(spatial_point p) const noexcept
+	{
+		return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y;
+	}
+
+	inline bool intersects(const spatial_box& other) const noexcept
+	{
+		return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y;
+	}
+};
+
+// Default projection for values that expose float x and y members.
+struct xy_position
+{
+	template<typename value_t>
+	inline spatial_point operator()(const value_t& value) const noexcept
+	{
+		return { static_cast<float>(value.x), static_cast<float>(value.y) };
+	}
+};
+
+template<typename F, typename T>
+concept spatial_position_fn = std::is_nothrow_default_constructible_v<F> && requires (const F f, const typename T::value_type& value)
+{
+	{ f(value) } noexcept -> std::same_as<spatial_point>;
+};
+
+} // namespace ecs
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "ecs/entity_id.h"
+
+#include <concepts>
+#include <cstdint>
+#include <limits>
+
+namespace ecs
+{
+
+// Compile-time storage options of a pool: the largest number of components it can
+// hold, the width of its dense indices (which also sizes its sparse pages) and
+// whether accessors validate entity ids in release builds.
+template<uint32_t max_size, std::unsigned_integral index_t = uint32_t, bool checked = true>
+struct storage_policy
+{
+	using index_type = index_t;
+
+	static constexpr uint32_t MAX_SIZE = max_size;
+	static constexpr bool CHECKED = checked;
+};
+
+using default_storage_policy = storage_policy<static_cast<uint32_t>(MAX_ENTITY_COUNT)>;
+
+template<uint32_t max_size = std::numeric_limits<uint16_t>::max() - 1, bool checked = true>
+using small_storage_policy = storage_policy<max_size, uint16_t, checked>;
+
+template<uint32_t max_size = static_cast<uint32_t>(MAX_ENTITY_COUNT), std::unsigned_integral index_t = uint32_t>
+using unchecked_storage_policy = storage_policy<max_size, index_t, false>;
+
+template<typename P>
+concept storage_policy_concept = requires
+{
+	typename P::index_type;
+	requires std::unsigned_integral<typename P::index_type>;
+	requires sizeof(typename P::index_type) <= sizeof(uint32_t);
+
+	{ P::MAX_SIZE } -> std::convertible_to<uint32_t>;
+	{ P::CHECKED } -> std::convertible_to<bool>;
+
+	requires P::MAX_SIZE > 0;
+	requires P::MAX_SIZE < std::numeric_limits<typename P::index_type>::max();
+};
+
+} // namespace ecs
@@ -1,6 +1,9 @@
 ﻿#pragma once
 
 #include "ecs/component_concept.h"
+#include "ecs/event_bus.h"
+
+#include <span>
 
 #include <tuple>
 
@@ -13,19 +16,43 @@ concept is_ecs_system = requires (T system, float dt, component_t*... ptrs)
 	system.proc(dt, ptrs...);
 };
 
+template<typename T, typename... component_t>
+concept is_ecs_entity_system = requires (T system, float dt, typename component_t::value_type&... values)
+{
+	system.proc_each(dt, values...);
+};
+
 
+// Derived systems implement either proc(float, component_t*...) to walk the pools
+// themselves, or proc_each(float, component_t::value_type&...) to be called once
+// per entity that has every component. Dispatch is static through derived_t.
 template<typename derived_t, ecs_component... component_t>
 struct system_base
 {
+	using components_type = std::tuple<component_t*...>;
+
 	void run(float delta_time);
 	void set(component_t*... ptrs) noexcept;
 
-protected:
+	template<typename fn_t>
+	void each(fn_t&& fn);
+
+	inline const components_type& components() const noexcept { return components_; }
+
+	inline void set_events(event_bus* events) noexcept { events_ = events; }
+	inline event_bus* events() const noexcept { return events_; }
+
+	// Events emitted this frame become readable after the bus is swapped. The bus
+	// must have a queue for E already; see event_bus.
+	template<typename E>
+	E* emit(const E& event) noexcept;
 
-	virtual void proc(float delta_time, component_t*... ptr) = 0;
+	template<typename E>
+	std::span<const E> read() const noexcept;
 
 private:
-	std::tuple<component_t*...> components_;
+	components_type components_;
+	event_bus* events_ = nullptr;
 };
  
 } // namespace ecs
@@ -2,22 +2,32 @@
 
 #include "system.h"
 
+#include <cassert>
+
 namespace ecs
 {
 
 template<typename derived_t, ecs_component ...component_t>
 inline void ecs::system_base<derived_t, component_t...>::run(float delta_time)
 {
-	static_assert(requires(derived_t& system, float dt, component_t*... ptrs)
+	if constexpr (is_ecs_system<derived_t, component_t...>)
 	{
-		system.proc(dt, ptrs...);
-	}, "derived system must implement proc(float, component_t*...)");
-
-	std::apply([this, delta_time](component_t*... ptrs)
+		std::apply([this, delta_time](component_t*... ptrs)
+		{
+			static_cast<derived_t*>(this)->proc(delta_time, ptrs...);
+		},
+		components_);
+	}
+	else
 	{
-		static_cast<derived_t*>(this)->proc(delta_time, ptrs...);
-	},
-	components_);
+		static_assert(is_ecs_entity_system<derived_t, component_t...>,
+			"derived system must implement proc(float, component_t*...) or proc_each(float, component_t::value_type&...)");
+
+		each([this, delta_time](typename component_t::value_type&... values)
+		{
+			static_cast<derived_t*>(this)->proc_each(delta_time, values...);
+		});
+	}
 }
 
 template<typename derived_t, ecs_component ...component_t>
@@ -26,4 +36,57 @@ inline void system_base<derived_t, component_t...>::set(component_t* ...ptrs) no
 	components_ = { ptrs... };
 }
 
+template<typename derived_t, ecs_component ...component_t>
+template<typename E>
+inline E* system_base<derived_t, component_t...>::emit(const E& event) noexcept
+{
+	assert(!events_ || events_->find<E>());
+
+	return events_ ? events_->emit(event) : nullptr;
+}
+
+template<typename derived_t, ecs_component ...component_t>
+template<typename E>
+inline std::span<const E> system_base<derived_t, component_t...>::read() const noexcept
+{
+	return events_ ? events_->read<E>() : std::span<const E>{};
+}
+
+template<typename derived_t, ecs_component ...component_t>
+template<typename fn_t>
+inline void system_base<derived_t, component_t...>::each(fn_t&& fn)
+{
+	std::apply([&fn](auto* first, auto*... rest)
+	{
+		if (!first || ((rest == nullptr) || ...))
+		{
+			return;
+		}
+
+		auto values = first->begin();
+
+		for (typename std::remove_pointer_t<decltype(first)>::size_type idx = 0; idx < first->size(); ++idx)
+		{
+			if constexpr (sizeof...(rest) == 0)
+			{
+				fn(values[idx]);
+			}
+			else
+			{
+				entity_id id = first->get_id(idx);
+
+				std::apply([&](auto*... found)
+				{
+					if (((found != nullptr) && ...))
+					{
+						fn(values[idx], *found...);
+					}
+				},
+				std::tuple { rest->get(id)... });
+			}
+		}
+	},
+	components_);
+}
+
 } // namespace ecs
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ecs/system.h"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+
+namespace ecs
+{
+
+// Runs systems in declaration order. Consecutive systems that implement proc_each
+// over the same component set are fused at compile time into a single pass over
+// the dense arrays, each entity being handed to every system of the group in turn.
+// Fusion assumes a proc_each only touches the entity it is given.
+template<typename... system_t>
+requires (sizeof...(system_t) > 0)
+struct system_pipeline
+{
+	static constexpr size_t SIZE = sizeof...(system_t);
+
+	system_pipeline() = default;
+
+	void run(float delta_time);
+
+	template<typename S>
+	S& get() noexcept;
+
+	template<size_t I>
+	auto& get() noexcept;
+
+	template<size_t I>
+	static constexpr size_t group_end() noexcept;
+
+private:
+
+	using systems_t = std::tuple<system_t...>;
+
+	template<size_t I>
+	using system_at_t = std::tuple_element_t<I, systems_t>;
+
+	systems_t systems_;
+
+	template<typename S>
+	static constexpr bool fusable_() noexcept;
+
+	template<size_t I, size_t J>
+	static constexpr size_t group_end_() noexcept;
+
+	template<size_t I>
+	void run_from_(float delta_time);
+
+	template<size_t I, size_t J>
+	void run_group_(float delta_time);
+
+	template<size_t I, size_t... K>
+	bool shares_pools_(std::index_sequence<K...>) const noexcept;
+
+	template<size_t I, size_t... K>
+	void run_fused_(float delta_time, std::index_sequence<K...>);
+};
+
+} // namespace ecs
+
+#include "ecs/system_pipeline.hpp"
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "ecs/system_pipeline.h"
+
+#include <utility>
+
+namespace ecs
+{
+
+template<typename... system_t>
+requires (sizeof...(system_t) > 0)
+inline void system_pipeline<system_t...>::run(float delta_time)
+{
+	run_from_<0>(delta_time);
+}
+
+template<typename... system_t>
+requires (sizeof...(system_t) > 0)
+template<typename S>
+inline S& system_pipeline<system_t...>::get() noexcept
+{
+	return std::get<S>(systems_);
+}
+
+template<typename... system_t>
+requires (sizeof...(system_t) > 0)
+template<size_t I>
+inline auto& system_pipeline<system_t...>::get() noexcept
+{
+	return std::get<I>(systems_);
+}
+
+template<typename... system_t>
+requires (sizeof...(system_t) > 0)
+template<size_t I>
+inline constexpr size_t system_pipeline<system_t...>::group_end() noexcept
+{
+	return group_end_<I, I + 1>();
+}
+
+template<typename... system_t>
+requires (sizeof...(system_t) > 0)
+template<typename S>
+inline constexpr bool system_pipeline<system_t...>::fusable_() noexcept
+{
+	return []<typename... component_t>(std::tuple<component_t*...>*)
+	{
+		return is_ecs_entity_system<S, component_t...> && !is_ecs_system<S, component_t...>;
+	}
+	(static_cast<typename S::components_type*>(nullptr));
+}
+
+template<typename... system_t>
+requires (sizeof...(system_t) > 0)
+template<size_t I, size_t J>
+inline constexpr size_t system_pipeline<system_t...>::group_end_() noexcept
+{
+	if constexpr (J >= SIZE)
+	{
+		return J;
+	}
+	else if constexpr (fusable_<system_at_t<I>>() && fusable_<system_at_t<J>>()
+		&& std::is_same_v<typename system_at_t<I>::components_type, typename system_at_t<J>::components_type>)
+	{
+		return group_end_<I, J + 1>();
+	}
+	else
+	{
+		return J;
+	}
+}
+
+template<typename... system_t>
+requires (sizeof...(system_t) > 0)
+template<size_t I>
+inline void system_pipeline<system_t...>::run_from_(float delta_time)
+{
+	if constexpr (I < SIZE)
+	{
+		constexpr size_t end = group_end<I>();
+
+		run_group_<I, end>(delta_time);
+		run_from_<end>(delta_time);
+	}
+}
+
+template<typename... system_t>
+requires (sizeof...(system_t) > 0)
+template<size_t I, size_t J>
+inline void system_pipeline<system_t...>::run_group_(float delta_time)
+{
+	if constexpr (J == I + 1)
+	{
+		std::get<I>(systems_).run(delta_time);
+	}
+	else
+	{
+		using group_t = std::make_index_sequence<J - I>;
+
+		if (shares_pools_<I>(group_t{}))
+		{
+			run_fused_<I>(delta_time, group_t{});
+		}
+		else
+		{
+			[this, delta_time]<size_t... K>(std::index_sequence<K...>)
+			{
+				(std::get<I + K>(systems_).run(delta_time), ...);
+			}
+			(group_t{});
+		}
+	}
+}
+
+template<typename... system_t>
+requires (sizeof...(system_t) > 0)
+template<size_t I, size_t... K>
+inline bool system_pipeline<system_t...>::shares_pools_(std::index_sequence<K...>) const noexcept
+{
+	return ((std::get<I + K>(systems_).components() == std::get<I>(systems_).components()) && ...);
+}
+
+template<typename... system_t>
+requires (sizeof...(system_t) > 0)
+template<size_t I, size_t... K>
+inline void system_pipeline<system_t...>::run_fused_(float delta_time, std::index_sequence<K...>)
+{
+	std::get<I>(systems_).each([this, delta_time](auto&... values)
+	{
+		(std::get<I + K>(systems_).proc_each(delta_time, values...), ...);
+	});
+}
+
+} // namespace ecs
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+namespace ecs
+{
+
+inline constexpr uint32_t THREAD_SLOT_COUNT = 64;
+
+// Small dense index of the calling thread, assigned on first use and handed back
+// when the thread exits. Per-thread lanes of lock-free structures are addressed
+// with it. Threads beyond THREAD_SLOT_COUNT alive at once all get
+// THREAD_SLOT_COUNT and take the structures' shared overflow path.
+uint32_t thread_slot() noexcept;
+
+} // namespace ecs
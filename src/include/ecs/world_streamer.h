@@ -0,0 +1,162 @@
+#pragma once
+
+#include "ecs/component_locator.h"
+#include "ecs/dynamic_array.h"
+#include "ecs/section_codec.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+namespace ecs
+{
+
+// Moves entity batches between files and a live world. Files are decoded and
+// encoded on background threads into staging buffers; the world itself is only
+// touched by commit() and unload(), which belong on the simulation thread at a
+// frame boundary. commit() inserts staged components in bulk until its time slice
+// is used up and resumes where it stopped on the next call.
+//
+// Components are stored as raw bytes tagged with the key they were registered
+// under, so only trivially copyable values can be streamed and files are only
+// portable between builds sharing the same layouts and byte order.
+//
+// unload() removes the entities from the world right away. If the file cannot be
+// written, the batch is counted in failed() and handed to commit() like a loaded
+// file, so the entities are reinserted rather than lost. Components commit() could
+// not insert are counted in failed() as well.
+struct world_streamer
+{
+	using size_type = uint32_t;
+	using key_type = uint64_t;
+	using clock_type = std::chrono::steady_clock;
+
+	static constexpr uint32_t FORMAT_MAGIC = 0x42534345;
+	static constexpr uint32_t FORMAT_VERSION = 2;
+	static constexpr size_type COMMIT_CHUNK = 1024;
+
+	world_streamer() noexcept = default;
+	~world_streamer() noexcept;
+
+	world_streamer(const world_streamer&) = delete;
+	world_streamer& operator=(const world_streamer&) = delete;
+
+	template<ecs_component T>
+	requires std::is_trivially_copyable_v<typename T::value_type>
+	bool register_component(key_type key) noexcept;
+
+	bool start(size_type thread_count = 1);
+	void stop() noexcept;
+
+	bool load(const char* path) noexcept;
+	size_type unload(component_locator& world, const entity_id* ids, size_type count, const char* path) noexcept;
+
+	size_type commit(component_locator& world, clock_type::duration budget) noexcept;
+
+	inline size_type pending() const noexcept { return pending_.load(std::memory_order_acquire); }
+	inline size_type failed() const noexcept { return failed_.load(std::memory_order_relaxed); }
+	inline bool running() const noexcept { return !threads_.empty(); }
+
+private:
+
+	struct _codec : section_codec
+	{
+		key_type key = 0;
+	};
+
+	struct _section
+	{
+		key_type key = 0;
+		uint32_t value_size = 0;
+		size_type count = 0;
+		size_t ids_offset = 0;
+		size_t values_offset = 0;
+	};
+
+	enum class _job
+	{
+		load,
+		store
+	};
+
+	static constexpr size_t DATA_ALIGNMENT = alignof(std::max_align_t);
+
+	// Staging bytes start on a DATA_ALIGNMENT boundary so values can be inserted
+	// straight from them; the default allocator only aligns to the element type.
+	template<typename U>
+	struct _data_allocator
+	{
+		using value_type = U;
+
+		inline value_type* allocate(size_t n) noexcept
+		{
+			return static_cast<value_type*>(::operator new(n * sizeof(U), std::align_val_t{ DATA_ALIGNMENT }, std::nothrow));
+		}
+
+		inline void deallocate(value_type* p, size_t) noexcept
+		{
+			::operator delete(static_cast<void*>(p), std::align_val_t{ DATA_ALIGNMENT }, std::nothrow);
+		}
+	};
+
+	struct _batch
+	{
+		_job job = _job::load;
+		dynamic_array<char> path;
+		dynamic_array<std::byte, _data_allocator> data;
+		dynamic_array<_section> sections;
+		size_type section = 0;
+		size_type offset = 0;
+		_batch* next = nullptr;
+	};
+
+	struct _queue
+	{
+		_batch* head = nullptr;
+		_batch* tail = nullptr;
+
+		void push(_batch* batch) noexcept;
+		_batch* pop() noexcept;
+	};
+
+	dynamic_array<_codec> codecs_;
+	dynamic_array<std::thread> threads_;
+
+	std::mutex mutex_;
+	std::condition_variable wake_;
+
+	_queue jobs_;
+	_queue ready_;
+	_queue free_;
+	bool stopping_ = false;
+
+	_batch* committing_ = nullptr;
+
+	std::atomic<size_type> pending_ = 0;
+	std::atomic<size_type> failed_ = 0;
+
+	const _codec* find_codec_(key_type key) const noexcept;
+
+	_batch* acquire_batch_() noexcept;
+	void release_batch_(_batch* batch) noexcept;
+	static void destroy_batch_(_batch* batch) noexcept;
+
+	static bool assign_path_(_batch& batch, const char* path) noexcept;
+	static bool append_(_batch& batch, size_t bytes, size_t& offset) noexcept;
+
+	void worker_() noexcept;
+	void finish_(_batch* batch, bool succeeded) noexcept;
+
+	static bool read_(_batch& batch) noexcept;
+	static bool write_(const _batch& batch) noexcept;
+};
+
+} // namespace ecs
+
+#include "ecs/world_streamer.hpp"
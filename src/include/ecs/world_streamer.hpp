@@ -0,0 +1,26 @@
+#pragma once
+
+#include "ecs/world_streamer.h"
+
+namespace ecs
+{
+
+template<ecs_component T>
+requires std::is_trivially_copyable_v<typename T::value_type>
+inline bool world_streamer::register_component(key_type key) noexcept
+{
+	using value_type = typename T::value_type;
+
+	static_assert(alignof(value_type) <= DATA_ALIGNMENT, "staging buffers do not honour over-aligned components");
+
+	if (running() || find_codec_(key))
+	{
+		return false;
+	}
+
+	_codec codec { section_codec::make<T>(), key };
+
+	return codecs_.emplace_back(codec) != nullptr;
+}
+
+} // namespace ecs
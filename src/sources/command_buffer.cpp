@@ -0,0 +1,158 @@
+#include "ecs/command_buffer.h"
+#include "ecs/thread_slot.h"
+
+#include <bit>
+#include <cstring>
+
+namespace ecs
+{
+
+command_buffer::command_buffer(entity_id_allocator* ids) noexcept
+	: ids_(ids)
+{
+}
+
+entity_id command_buffer::create() noexcept
+{
+	return ids_ ? ids_->allocate() : INVALID_ENTITY_ID;
+}
+
+bool command_buffer::destroy(entity_id id) noexcept
+{
+	return record_(_op::destroy, nullptr, id, nullptr, 0);
+}
+
+command_buffer::size_type command_buffer::flush(component_locator& world) noexcept
+{
+	size_type applied = 0;
+
+	for (uint64_t active = active_lanes_.exchange(0, std::memory_order_acquire); active != 0; active &= active - 1)
+	{
+		applied += replay_(lanes_[std::countr_zero(active)], world);
+	}
+
+	applied += replay_(overflow_, world);
+
+	return applied;
+}
+
+void command_buffer::clear() noexcept
+{
+	for (_lane& lane : lanes_)
+	{
+		lane.stream.clear();
+		lane.count = 0;
+	}
+
+	overflow_.stream.clear();
+	overflow_.count = 0;
+
+	active_lanes_.store(0, std::memory_order_relaxed);
+}
+
+command_buffer::size_type command_buffer::pending() const noexcept
+{
+	size_type total = overflow_.count;
+
+	for (const _lane& lane : lanes_)
+	{
+		total += lane.count;
+	}
+
+	return total;
+}
+
+bool command_buffer::record_(_op op, apply_fn apply, entity_id id, const void* payload, uint32_t size) noexcept
+{
+	if (id == INVALID_ENTITY_ID)
+	{
+		return false;
+	}
+
+	_command command { apply, id, op, size };
+	uint32_t slot = thread_slot();
+
+	if (slot < MAX_LANES)
+	{
+		_lane& lane = lanes_[slot];
+
+		if (lane.count == 0)
+		{
+			active_lanes_.fetch_or(uint64_t{ 1 } << slot, std::memory_order_relaxed);
+		}
+
+		return append_(lane, command, payload);
+	}
+
+	while (overflow_lock_.test_and_set(std::memory_order_acquire))
+	{
+		overflow_lock_.wait(true, std::memory_order_relaxed);
+	}
+
+	bool recorded = append_(overflow_, command, payload);
+
+	overflow_lock_.clear(std::memory_order_release);
+	overflow_lock_.notify_one();
+	return recorded;
+}
+
+bool command_buffer::append_(_lane& lane, const _command& command, const void* payload) noexcept
+{
+	size_t offset = lane.stream.size();
+
+	if (!lane.stream.resize(offset + sizeof(_command) + command.size))
+	{
+		return false;
+	}
+
+	std::byte* data = lane.stream.data() + offset;
+
+	std::memcpy(data, &command, sizeof(_command));
+
+	if (command.size)
+	{
+		std::memcpy(data + sizeof(_command), payload, command.size);
+	}
+
+	++lane.count;
+	return true;
+}
+
+command_buffer::size_type command_buffer::replay_(_lane& lane, component_locator& world) noexcept
+{
+	const std::byte* data = lane.stream.data();
+	size_t size = lane.stream.size();
+
+	for (size_t offset = 0; offset < size;)
+	{
+		_command command;
+		std::memcpy(&command, data + offset, sizeof(_command));
+
+		const std::byte* payload = data + offset + sizeof(_command);
+
+		if (command.op == _op::destroy)
+		{
+			world.remove_entity(command.id);
+
+			if (ids_)
+			{
+				ids_->release(command.id);
+			}
+		}
+		else
+		{
+			command.apply(world, command.id, payload);
+		}
+
+		offset += sizeof(_command) + command.size;
+	}
+
+	size_type applied = lane.count;
+
+	lane.stream.clear();
+	lane.count = 0;
+
+	return applied;
+}
+
+} // namespace ecs
@@ -1,10 +1,20 @@
 ﻿#include "ecs/component_locator.h"
 
+#include <cstring>
+
 namespace ecs
 {
 
 component_locator::~component_locator() noexcept
 {
+	for (queries_t::size_type idx = 0; idx < queries_.size(); ++idx)
+	{
+		if (queries_[idx].p && queries_[idx].deleter)
+		{
+			queries_[idx].deleter(queries_[idx].p);
+		}
+	}
+
 	for (container_t::size_type idx = 0; idx < container_.size(); ++idx)
 	{
 		if (container_[idx].p && container_[idx].deleter)
@@ -14,4 +24,335 @@ component_locator::~component_locator() noexcept
 	}
 }
 
+runtime_component* component_locator::add(const component_descriptor& descriptor) noexcept
+{
+	component_index idx = acquire_runtime_type_index_(descriptor.name);
+
+	if (idx == INVALID_COMPONENT_INDEX || idx >= MAX_SIZE)
+	{
+		return nullptr;
+	}
+
+	if (idx >= container_.size() && !container_.resize(idx + 1))
+	{
+		return nullptr;
+	}
+
+	runtime_component* p = default_allocator<runtime_component>{}.allocate(1);
+
+	if (p == nullptr)
+	{
+		return nullptr;
+	}
+
+	std::construct_at(p, descriptor);
+
+	if (!p->valid())
+	{
+		std::destroy_at(p);
+		default_allocator<runtime_component>{}.deallocate(p, 1);
+		return nullptr;
+	}
+
+	if (container_[idx].p)
+	{
+		container_[idx].deleter(container_[idx].p);
+	}
+
+	_type_erasure_storage storage = make_runtime_storage_();
+	storage.p = p;
+
+	container_[idx] = storage;
+
+	p->set_budget(budget_);
+
+	return p;
+}
+
+void component_locator::remove(const char* name) noexcept
+{
+	component_index idx = runtime_index(name);
+
+	if (idx == INVALID_COMPONENT_INDEX || idx >= container_.size() || !container_[idx].p)
+	{
+		return;
+	}
+
+	container_[idx].deleter(container_[idx].p);
+	container_[idx] = {};
+}
+
+bool component_locator::has(const char* name) const noexcept
+{
+	return get(name) != nullptr;
+}
+
+runtime_component* component_locator::get(const char* name) const noexcept
+{
+	return get(runtime_index(name));
+}
+
+runtime_component* component_locator::get(component_index idx) const noexcept
+{
+	if (idx == INVALID_COMPONENT_INDEX || idx >= container_.size() || !container_[idx].runtime)
+	{
+		return nullptr;
+	}
+
+	return static_cast<runtime_component*>(container_[idx].p);
+}
+
+void component_locator::remove_entity(entity_id id) noexcept
+{
+	for (container_t::size_type idx = 0; idx < container_.size(); ++idx)
+	{
+		if (container_[idx].p)
+		{
+			container_[idx].erase(container_[idx].p, id);
+		}
+	}
+}
+
+void component_locator::set_budget(memory_budget* budget) noexcept
+{
+	budget_ = budget;
+
+	for (container_t::size_type idx = 0; idx < container_.size(); ++idx)
+	{
+		if (container_[idx].p)
+		{
+			container_[idx].set_budget(container_[idx].p, budget);
+		}
+	}
+}
+
+size_t component_locator::memory_usage() const noexcept
+{
+	size_t usage = sizeof(_type_erasure_storage) * container_.capacity();
+
+	for (container_t::size_type idx = 0; idx < container_.size(); ++idx)
+	{
+		if (container_[idx].p)
+		{
+			usage += container_[idx].memory_usage(container_[idx].p);
+		}
+	}
+
+	return usage;
+}
+
+void component_locator::shrink_to_fit() noexcept
+{
+	for (container_t::size_type idx = 0; idx < container_.size(); ++idx)
+	{
+		if (container_[idx].p)
+		{
+			container_[idx].shrink_to_fit(container_[idx].p);
+		}
+	}
+
+	while (!container_.empty() && !container_.back().p)
+	{
+		container_.pop_back();
+	}
+
+	container_.shrink_to_fit();
+}
+
+bool component_locator::restore_from(const component_locator& other) noexcept
+{
+	if (this == &other)
+	{
+		return true;
+	}
+
+	if (other.container_.size() > container_.size() && !container_.resize(other.container_.size()))
+	{
+		return false;
+	}
+
+	bool restored = true;
+
+	for (container_t::size_type idx = 0; idx < container_.size(); ++idx)
+	{
+		_type_erasure_storage& dst = container_[idx];
+
+		if (idx >= other.container_.size() || !other.container_[idx].p)
+		{
+			if (dst.p)
+			{
+				dst.clear(dst.p);
+			}
+
+			continue;
+		}
+
+		const _type_erasure_storage& src = other.container_[idx];
+
+		if (!src.restore)
+		{
+			continue;
+		}
+
+		if (!dst.p)
+		{
+			void* p = src.create(src.p);
+
+			if (!p)
+			{
+				restored = false;
+				continue;
+			}
+
+			dst = src;
+			dst.p = p;
+			dst.set_budget(p, budget_);
+		}
+
+		if (!dst.restore(dst.p, src.p))
+		{
+			restored = false;
+		}
+	}
+
+	return restored;
+}
+
+bool component_locator::clone_to(component_locator& other) const noexcept
+{
+	return other.restore_from(*this);
+}
+
+component_locator::_runtime_types::~_runtime_types() noexcept
+{
+	for (std::atomic<_runtime_type*>& slot : slots)
+	{
+		if (_runtime_type* type = slot.load(std::memory_order_relaxed))
+		{
+			std::destroy_at(type);
+			default_allocator<_runtime_type>{}.deallocate(type, 1);
+		}
+	}
+}
+
+component_locator::component_index component_locator::runtime_index(const char* name) noexcept
+{
+	if (!name)
+	{
+		return INVALID_COMPONENT_INDEX;
+	}
+
+	const _runtime_type* type = runtime_types_.slots[runtime_slot_(name)].load(std::memory_order_acquire);
+	return type ? type->index : INVALID_COMPONENT_INDEX;
+}
+
+component_locator::size_type component_locator::runtime_slot_(const char* name) noexcept
+{
+	// FNV-1a; at most MAX_SIZE names in twice as many slots, so probing ends on
+	// the name or on an empty slot.
+	uint32_t hash = 2166136261u;
+
+	for (const char* c = name; *c; ++c)
+	{
+		hash = (hash ^ static_cast<unsigned char>(*c)) * 16777619u;
+	}
+
+	for (size_type slot = hash & (_runtime_types::SLOTS - 1);; slot = (slot + 1) & (_runtime_types::SLOTS - 1))
+	{
+		const _runtime_type* type = runtime_types_.slots[slot].load(std::memory_order_acquire);
+
+		if (!type || std::strcmp(type->name.data(), name) == 0)
+		{
+			return slot;
+		}
+	}
+}
+
+component_locator::component_index component_locator::acquire_runtime_type_index_(const char* name) noexcept
+{
+	if (!name)
+	{
+		return INVALID_COMPONENT_INDEX;
+	}
+
+	std::lock_guard<std::mutex> lock(types_mutex_);
+
+	std::atomic<_runtime_type*>& slot = runtime_types_.slots[runtime_slot_(name)];
+
+	if (const _runtime_type* type = slot.load(std::memory_order_relaxed))
+		return type->index;
+
+	if (next_component_index_ >= MAX_SIZE)
+		return INVALID_COMPONENT_INDEX;
+
+	_runtime_type* type = default_allocator<_runtime_type>{}.allocate(1);
+
+	if (!type)
+		return INVALID_COMPONENT_INDEX;
+
+	std::construct_at(type);
+
+	if (!type->name.assign(name, std::strlen(name) + 1))
+	{
+		std::destroy_at(type);
+		default_allocator<_runtime_type>{}.deallocate(type, 1);
+		return INVALID_COMPONENT_INDEX;
+	}
+
+	type->index = next_component_index_;
+	slot.store(type, std::memory_order_release);
+
+	return next_component_index_++;
+}
+
+component_locator::_type_erasure_storage component_locator::make_runtime_storage_() noexcept
+{
+	_type_erasure_storage storage {};
+
+	storage.runtime = true;
+	storage.deleter = [](void* ptr)
+	{
+		runtime_component* p = static_cast<runtime_component*>(ptr);
+		std::destroy_at(p);
+		default_allocator<runtime_component>{}.deallocate(p, 1);
+	};
+	storage.memory_usage = [](const void* ptr)
+	{
+		return static_cast<const runtime_component*>(ptr)->memory_usage();
+	};
+	storage.shrink_to_fit = [](void* ptr)
+	{
+		static_cast<runtime_component*>(ptr)->shrink_to_fit();
+	};
+	storage.set_budget = [](void* ptr, memory_budget* budget)
+	{
+		static_cast<runtime_component*>(ptr)->set_budget(budget);
+	};
+	storage.create = [](const void* prototype) -> void*
+	{
+		runtime_component* p = default_allocator<runtime_component>{}.allocate(1);
+
+		if (p == nullptr)
+		{
+			return nullptr;
+		}
+
+		return static_cast<void*>(std::construct_at(p, static_cast<const runtime_component*>(prototype)->descriptor()));
+	};
+	storage.clear = [](void* ptr)
+	{
+		static_cast<runtime_component*>(ptr)->clear();
+	};
+	storage.erase = [](void* ptr, entity_id id)
+	{
+		static_cast<runtime_component*>(ptr)->remove(id);
+	};
+	storage.restore = [](void* dst, const void* src)
+	{
+		return static_cast<runtime_component*>(dst)->restore_from(*static_cast<const runtime_component*>(src));
+	};
+
+	return storage;
+}
+
 } // namespace ecs
@@ -0,0 +1,243 @@
+#include "ecs/compression.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace ecs
+{
+
+namespace
+{
+
+constexpr size_t MIN_MATCH = 4;
+constexpr size_t MAX_OFFSET = 0xffff;
+constexpr uint32_t HASH_BITS = 12;
+
+inline uint32_t read32_(const uint8_t* p) noexcept
+{
+	uint32_t value;
+	std::memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+inline uint32_t hash_(uint32_t sequence) noexcept
+{
+	return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+struct _writer
+{
+	uint8_t* out;
+	uint8_t* end;
+
+	inline bool put(uint8_t byte) noexcept
+	{
+		if (out == end)
+		{
+			return false;
+		}
+
+		*out++ = byte;
+		return true;
+	}
+
+	inline bool put_length(size_t length) noexcept
+	{
+		for (; length >= 255; length -= 255)
+		{
+			if (!put(255))
+			{
+				return false;
+			}
+		}
+
+		return put(static_cast<uint8_t>(length));
+	}
+
+	inline bool put_bytes(const uint8_t* bytes, size_t count) noexcept
+	{
+		if (static_cast<size_t>(end - out) < count)
+		{
+			return false;
+		}
+
+		if (count)
+		{
+			std::memcpy(out, bytes, count);
+		}
+
+		out += count;
+		return true;
+	}
+
+	// A sequence with match == 0 is the trailing literal run that ends the stream.
+	bool sequence(const uint8_t* literals, size_t literal_count, size_t offset, size_t match) noexcept
+	{
+		size_t match_code = match ? match - MIN_MATCH : 0;
+		uint8_t token = static_cast<uint8_t>((literal_count < 15 ? literal_count : 15) << 4 | (match_code < 15 ? match_code : 15));
+
+		if (!put(token) || (literal_count >= 15 && !put_length(literal_count - 15)) || !put_bytes(literals, literal_count))
+		{
+			return false;
+		}
+
+		if (match == 0)
+		{
+			return true;
+		}
+
+		return put(static_cast<uint8_t>(offset)) && put(static_cast<uint8_t>(offset >> 8)) && (match_code < 15 || put_length(match_code - 15));
+	}
+};
+
+inline bool read_length_(const uint8_t*& in, const uint8_t* end, size_t& length) noexcept
+{
+	uint8_t byte;
+
+	do
+	{
+		if (in == end)
+		{
+			return false;
+		}
+
+		byte = *in++;
+		length += byte;
+	}
+	while (byte == 255);
+
+	return true;
+}
+
+} // namespace
+
+size_t compress_bound(size_t size) noexcept
+{
+	return size + size / 255 + 16;
+}
+
+size_t compress(const void* src, size_t size, void* dst, size_t capacity) noexcept
+{
+	const uint8_t* in = static_cast<const uint8_t*>(src);
+	_writer writer { static_cast<uint8_t*>(dst), static_cast<uint8_t*>(dst) + capacity };
+
+	uint32_t table[1u << HASH_BITS] = {};
+
+	size_t anchor = 0;
+	size_t pos = 0;
+
+	// Positions are only 32 bits wide in the table; larger inputs are not expected
+	// here and would just match less.
+	while (pos + MIN_MATCH <= size)
+	{
+		uint32_t sequence = read32_(in + pos);
+		uint32_t& slot = table[hash_(sequence)];
+		size_t candidate = slot;
+
+		slot = static_cast<uint32_t>(pos);
+
+		if (candidate >= pos || pos - candidate > MAX_OFFSET || read32_(in + candidate) != sequence)
+		{
+			// Skip ahead faster through data that keeps failing to match.
+			pos += 1 + ((pos - anchor) >> 6);
+			continue;
+		}
+
+		size_t match = MIN_MATCH;
+
+		while (pos + match < size && in[candidate + match] == in[pos + match])
+		{
+			++match;
+		}
+
+		if (!writer.sequence(in + anchor, pos - anchor, pos - candidate, match))
+		{
+			return 0;
+		}
+
+		pos += match;
+		anchor = pos;
+	}
+
+	if (!writer.sequence(in + anchor, size - anchor, 0, 0))
+	{
+		return 0;
+	}
+
+	return static_cast<size_t>(writer.out - static_cast<uint8_t*>(dst));
+}
+
+bool decompress(const void* src, size_t src_size, void* dst, size_t size) noexcept
+{
+	const uint8_t* in = static_cast<const uint8_t*>(src);
+	const uint8_t* in_end = in + src_size;
+
+	uint8_t* base = static_cast<uint8_t*>(dst);
+	uint8_t* out = base;
+	uint8_t* out_end = base + size;
+
+	while (in < in_end)
+	{
+		uint8_t token = *in++;
+		size_t literals = token >> 4;
+
+		if (literals == 15 && !read_length_(in, in_end, literals))
+		{
+			return false;
+		}
+
+		if (static_cast<size_t>(in_end - in) < literals || static_cast<size_t>(out_end - out) < literals)
+		{
+			return false;
+		}
+
+		if (literals)
+		{
+			std::memcpy(out, in, literals);
+		}
+
+		in += literals;
+		out += literals;
+
+		if (in == in_end)
+		{
+			break;
+		}
+
+		if (in_end - in < 2)
+		{
+			return false;
+		}
+
+		size_t offset = size_t{ in[0] } | size_t{ in[1] } << 8;
+		in += 2;
+
+		size_t match = token & 15;
+
+		if (match == 15 && !read_length_(in, in_end, match))
+		{
+			return false;
+		}
+
+		match += MIN_MATCH;
+
+		if (offset == 0 || offset > static_cast<size_t>(out - base) || static_cast<size_t>(out_end - out) < match)
+		{
+			return false;
+		}
+
+		// Byte by byte: the source may overlap what is being written.
+		const uint8_t* from = out - offset;
+
+		for (size_t idx = 0; idx < match; ++idx)
+		{
+			out[idx] = from[idx];
+		}
+
+		out += match;
+	}
+
+	return out == out_end;
+}
+
+} // namespace ecs
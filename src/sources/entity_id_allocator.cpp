@@ -0,0 +1,222 @@
+#include "ecs/entity_id_allocator.h"
+#include "ecs/thread_slot.h"
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+namespace ecs
+{
+
+entity_id_allocator::entity_id_allocator(entity_index_type capacity) noexcept
+	: capacity_(std::min<entity_index_type>(capacity, MAX_ENTITY_COUNT))
+{
+	free_next_ = static_cast<std::atomic<entity_index_type>*>(::operator new(sizeof(std::atomic<entity_index_type>) * capacity_, std::nothrow));
+
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		generations_ = static_cast<std::atomic<entity_generation_type>*>(::operator new(sizeof(std::atomic<entity_generation_type>) * capacity_, std::nothrow));
+	}
+
+	if (!free_next_ || (ENTITY_GENERATION_BITS > 0 && !generations_))
+	{
+		::operator delete(static_cast<void*>(free_next_), std::nothrow);
+		::operator delete(static_cast<void*>(generations_), std::nothrow);
+
+		free_next_ = nullptr;
+		generations_ = nullptr;
+		capacity_ = 0;
+		return;
+	}
+
+	std::uninitialized_fill_n(free_next_, capacity_, NOT_FREE);
+
+	if (generations_)
+	{
+		std::uninitialized_value_construct_n(generations_, capacity_);
+	}
+}
+
+entity_id_allocator::~entity_id_allocator() noexcept
+{
+	if (free_next_)
+	{
+		std::destroy_n(free_next_, capacity_);
+		::operator delete(static_cast<void*>(free_next_), std::nothrow);
+	}
+
+	if (generations_)
+	{
+		std::destroy_n(generations_, capacity_);
+		::operator delete(static_cast<void*>(generations_), std::nothrow);
+	}
+}
+
+entity_id entity_id_allocator::allocate() noexcept
+{
+	entity_index_type index = pop_free_();
+
+	if (index != INVALID_INDEX)
+	{
+		return id_at(index);
+	}
+
+	uint32_t slot = thread_slot();
+
+	if (slot >= MAX_LANES)
+	{
+		entity_range range = reserve_(1, false);
+		return range.empty() ? INVALID_ENTITY_ID : range.first;
+	}
+
+	_lane& lane = lanes_[slot];
+
+	if (lane.next == lane.end)
+	{
+		entity_range block = reserve_(BLOCK_SIZE, true);
+
+		if (block.empty())
+		{
+			return INVALID_ENTITY_ID;
+		}
+
+		lane.next = entity_index(block.first);
+		lane.end = lane.next + block.count;
+	}
+
+	return make_entity_id(lane.next++);
+}
+
+entity_range entity_id_allocator::allocate(size_type count) noexcept
+{
+	if (count == 0)
+	{
+		return {};
+	}
+
+	return reserve_(count, false);
+}
+
+void entity_id_allocator::release(entity_id id) noexcept
+{
+	entity_index_type index = entity_index(id);
+
+	// Indices past the high-water mark were never handed out; freeing one would
+	// let it be allocated twice, once from the free list and once fresh.
+	if (id == INVALID_ENTITY_ID || index >= high_water())
+	{
+		return;
+	}
+
+	// Only the release that moves the generation on gets to recycle the index.
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		entity_generation_type generation = entity_generation(id);
+
+		if (!generations_[index].compare_exchange_strong(generation, generation + 1, std::memory_order_relaxed))
+		{
+			return;
+		}
+	}
+	else
+	{
+		entity_index_type not_free = NOT_FREE;
+
+		// A second release would link the index to itself and hand it out forever.
+		if (!free_next_[index].compare_exchange_strong(not_free, INVALID_INDEX, std::memory_order_relaxed))
+		{
+			return;
+		}
+	}
+
+	push_free_(index);
+}
+
+entity_id entity_id_allocator::id_at(entity_index_type index) const noexcept
+{
+	if (index >= capacity_)
+	{
+		return INVALID_ENTITY_ID;
+	}
+
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		return make_entity_id(index, generations_[index].load(std::memory_order_relaxed));
+	}
+	else
+	{
+		return make_entity_id(index);
+	}
+}
+
+void entity_id_allocator::reset() noexcept
+{
+	next_.store(0, std::memory_order_relaxed);
+	free_head_.store(EMPTY_HEAD, std::memory_order_relaxed);
+	lanes_ = {};
+
+	for (entity_index_type i = 0; i < capacity_; ++i)
+	{
+		free_next_[i].store(NOT_FREE, std::memory_order_relaxed);
+
+		if (generations_)
+		{
+			generations_[i].store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+entity_index_type entity_id_allocator::pop_free_() noexcept
+{
+	uint64_t head = free_head_.load(std::memory_order_acquire);
+
+	while (index_of_(head) != INVALID_INDEX)
+	{
+		entity_index_type index = index_of_(head);
+		entity_index_type next = free_next_[index].load(std::memory_order_relaxed);
+
+		if (free_head_.compare_exchange_weak(head, head_of_(head, next), std::memory_order_acquire, std::memory_order_acquire))
+		{
+			free_next_[index].store(NOT_FREE, std::memory_order_relaxed);
+			return index;
+		}
+	}
+
+	return INVALID_INDEX;
+}
+
+void entity_id_allocator::push_free_(entity_index_type index) noexcept
+{
+	uint64_t head = free_head_.load(std::memory_order_relaxed);
+
+	do
+	{
+		free_next_[index].store(index_of_(head), std::memory_order_relaxed);
+	}
+	while (!free_head_.compare_exchange_weak(head, head_of_(head, index), std::memory_order_release, std::memory_order_relaxed));
+}
+
+entity_range entity_id_allocator::reserve_(size_type count, bool partial) noexcept
+{
+	entity_index_type first = next_.load(std::memory_order_relaxed);
+
+	// Only a reservation that fits moves the counter, so a failed request does
+	// not strand the ids that are left.
+	for (;;)
+	{
+		if (first >= capacity_ || (!partial && count > capacity_ - first))
+		{
+			return {};
+		}
+
+		size_type reserved = std::min<entity_index_type>(count, capacity_ - first);
+
+		if (next_.compare_exchange_weak(first, first + reserved, std::memory_order_relaxed))
+		{
+			// Fresh indices have never been released, so their generation is still 0.
+			return { make_entity_id(first), reserved };
+		}
+	}
+}
+
+} // namespace ecs
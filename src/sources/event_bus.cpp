@@ -0,0 +1,52 @@
+#include "ecs/event_bus.h"
+
+namespace ecs
+{
+
+event_bus::event_bus(frame_arena::size_type arena_chunk_size) noexcept
+	: arena_(arena_chunk_size)
+{
+}
+
+event_bus::~event_bus() noexcept
+{
+	for (const _queue_storage& storage : queues_)
+	{
+		if (storage.p)
+		{
+			storage.deleter(storage.p);
+		}
+	}
+}
+
+bool event_bus::swap() noexcept
+{
+	arena_.reset();
+
+	bool published = true;
+
+	for (const _queue_storage& storage : queues_)
+	{
+		if (storage.p)
+		{
+			published = storage.publish(storage.p, arena_) && published;
+		}
+	}
+
+	return published;
+}
+
+void event_bus::clear() noexcept
+{
+	for (const _queue_storage& storage : queues_)
+	{
+		if (storage.p)
+		{
+			storage.clear(storage.p);
+		}
+	}
+
+	arena_.reset();
+}
+
+} // namespace ecs
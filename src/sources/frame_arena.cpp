@@ -0,0 +1,135 @@
+#include "ecs/frame_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+namespace ecs
+{
+
+frame_arena::frame_arena(size_type chunk_size) noexcept
+	: chunk_size_(std::max<size_type>(chunk_size, CHUNK_ALIGNMENT))
+{
+}
+
+frame_arena::~frame_arena() noexcept
+{
+	release();
+}
+
+void* frame_arena::allocate(size_type bytes, size_type alignment) noexcept
+{
+	if (bytes == 0)
+	{
+		bytes = 1;
+	}
+
+	for (; current_ < chunks_.size(); ++current_, offset_ = 0)
+	{
+		const _chunk& chunk = chunks_[current_];
+
+		uintptr_t base = reinterpret_cast<uintptr_t>(chunk.data);
+		size_type offset = static_cast<size_type>(((base + offset_ + alignment - 1) & ~(uintptr_t{ alignment } - 1)) - base);
+
+		if (offset <= chunk.size && bytes <= chunk.size - offset)
+		{
+			offset_ = offset + bytes;
+			used_ += bytes;
+
+			return chunk.data + offset;
+		}
+	}
+
+	if (!add_chunk_(std::max(chunk_size_, bytes + alignment)))
+	{
+		return nullptr;
+	}
+
+	current_ = chunks_.size() - 1;
+	offset_ = 0;
+
+	return allocate(bytes, alignment);
+}
+
+bool frame_arena::reserve(size_type bytes) noexcept
+{
+	if (capacity() >= bytes)
+	{
+		return true;
+	}
+
+	if (used_ == 0)
+	{
+		release();
+	}
+
+	return add_chunk_(bytes - capacity());
+}
+
+void frame_arena::reset() noexcept
+{
+	if (chunks_.size() > 1)
+	{
+		size_type total = capacity();
+
+		release();
+		add_chunk_(total);
+	}
+
+	current_ = 0;
+	offset_ = 0;
+	used_ = 0;
+}
+
+void frame_arena::release() noexcept
+{
+	for (const _chunk& chunk : chunks_)
+	{
+		free_chunk_(chunk);
+	}
+
+	chunks_.clear();
+
+	current_ = 0;
+	offset_ = 0;
+	used_ = 0;
+}
+
+frame_arena::size_type frame_arena::capacity() const noexcept
+{
+	size_type total = 0;
+
+	for (const _chunk& chunk : chunks_)
+	{
+		total += chunk.size;
+	}
+
+	return total;
+}
+
+bool frame_arena::add_chunk_(size_type size) noexcept
+{
+	size = (size + CHUNK_ALIGNMENT - 1) & ~(CHUNK_ALIGNMENT - 1);
+
+	_chunk chunk { static_cast<std::byte*>(::operator new(size, std::align_val_t{ CHUNK_ALIGNMENT }, std::nothrow)), size };
+
+	if (!chunk.data)
+	{
+		return false;
+	}
+
+	if (!chunks_.emplace_back(chunk))
+	{
+		free_chunk_(chunk);
+		return false;
+	}
+
+	return true;
+}
+
+void frame_arena::free_chunk_(const _chunk& chunk) noexcept
+{
+	::operator delete(static_cast<void*>(chunk.data), std::align_val_t{ CHUNK_ALIGNMENT }, std::nothrow);
+}
+
+} // namespace ecs
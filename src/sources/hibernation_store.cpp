@@ -0,0 +1,606 @@
+#include "ecs/hibernation_store.h"
+#include "ecs/compression.h"
+
+#include <cstring>
+#include <utility>
+
+namespace ecs
+{
+
+hibernation_store::size_type hibernation_store::hibernate(component_locator& world, const entity_id* ids, size_type count) noexcept
+{
+	ids_.clear();
+
+	for (size_type idx = 0; idx < count; ++idx)
+	{
+		entity_id id = ids[idx];
+
+		if (!entity_id_in_range(id) || block_of_.find(id) != INVALID_BLOCK || !block_of_.acquire(id, nullptr))
+		{
+			continue;
+		}
+
+		if (!ids_.emplace_back(id))
+		{
+			break;
+		}
+
+		// Marked right away so duplicates in the input are skipped.
+		block_of_.set(id, WAKING);
+	}
+
+	size_type hibernated = 0;
+
+	for (size_t first = 0; first < ids_.size(); first += BLOCK_ENTITIES)
+	{
+		size_t remaining = ids_.size() - first;
+		hibernated += pack_(world, ids_.data() + first, static_cast<size_type>(remaining < BLOCK_ENTITIES ? remaining : BLOCK_ENTITIES));
+	}
+
+	return hibernated;
+}
+
+hibernation_store::size_type hibernation_store::pack_(component_locator& world, const entity_id* ids, size_type entity_count) noexcept
+{
+	// Values are copied out and the block stored before anything leaves the pools,
+	// so a failure at any point leaves the world as it was.
+	size_t worst = sizeof(_block_header) + sizeof(entity_id) * entity_count;
+	size_t value_size = 0;
+
+	for (const section_codec& codec : codecs_)
+	{
+		worst += sizeof(_section_header) + (sizeof(uint32_t) + codec.value_size) * size_t{ entity_count };
+		value_size = codec.value_size > value_size ? codec.value_size : value_size;
+	}
+
+	raw_.clear();
+
+	uint32_t index = INVALID_BLOCK;
+
+	if (raw_.reserve(worst) && slots_.resize(entity_count) && stage_values_(value_size * entity_count))
+	{
+		_block_header header { entity_count, 0 };
+
+		append_(&header, sizeof(header));
+		append_(ids, sizeof(entity_id) * entity_count);
+
+		for (uint32_t codec = 0; codec < codecs_.size(); ++codec)
+		{
+			const section_codec& entry = codecs_[codec];
+			size_type found = entry.gather(world, ids, entity_count, slots_.data(), values_.data());
+
+			if (found == 0)
+			{
+				continue;
+			}
+
+			_section_header section { codec, found };
+
+			append_(&section, sizeof(section));
+			append_(slots_.data(), sizeof(uint32_t) * found);
+			append_(values_.data(), size_t{ entry.value_size } * found);
+
+			++header.section_count;
+		}
+
+		std::memcpy(raw_.data(), &header, sizeof(header));
+
+		index = acquire_block_();
+	}
+
+	if (index != INVALID_BLOCK)
+	{
+		_block& block = blocks_[index];
+
+		if (!fill_alive_(block.alive, entity_count) || !store_(block))
+		{
+			drop_(index);
+			index = INVALID_BLOCK;
+		}
+	}
+
+	if (index == INVALID_BLOCK)
+	{
+		for (size_type idx = 0; idx < entity_count; ++idx)
+		{
+			block_of_.reset(ids[idx]);
+		}
+
+		return 0;
+	}
+
+	_block& block = blocks_[index];
+
+	block.entity_count = entity_count;
+	block.live = entity_count;
+
+	for (const section_codec& codec : codecs_)
+	{
+		codec.erase(world, ids, entity_count);
+	}
+
+	for (size_type idx = 0; idx < entity_count; ++idx)
+	{
+		block_of_.set(ids[idx], index);
+	}
+
+	size_ += entity_count;
+	return entity_count;
+}
+
+hibernation_store::size_type hibernation_store::wake(component_locator& world, const entity_id* ids, size_type count) noexcept
+{
+	return release_(&world, ids, count);
+}
+
+hibernation_store::size_type hibernation_store::discard(const entity_id* ids, size_type count) noexcept
+{
+	return release_(nullptr, ids, count);
+}
+
+bool hibernation_store::hibernating(entity_id id) const noexcept
+{
+	return entity_id_in_range(id) && block_of_.find(id) != INVALID_BLOCK;
+}
+
+void hibernation_store::clear() noexcept
+{
+	blocks_.clear();
+	free_blocks_.clear();
+	block_of_.clear();
+
+	size_ = 0;
+	raw_bytes_ = 0;
+	compressed_bytes_ = 0;
+}
+
+void hibernation_store::shrink_to_fit() noexcept
+{
+	for (_block& block : blocks_)
+	{
+		block.data.shrink_to_fit();
+	}
+
+	blocks_.shrink_to_fit();
+	free_blocks_.shrink_to_fit();
+	block_of_.shrink_to_fit();
+
+	raw_ = {};
+	packed_ = {};
+	values_ = {};
+	ids_ = {};
+	gathered_ = {};
+	slots_ = {};
+	owners_ = {};
+	touched_ = {};
+	mask_ = {};
+	rejected_ = {};
+}
+
+size_t hibernation_store::memory_usage() const noexcept
+{
+	size_t usage = sizeof(_block) * blocks_.capacity() + sizeof(uint32_t) * free_blocks_.capacity() + block_of_.memory_usage();
+
+	for (const _block& block : blocks_)
+	{
+		usage += block.data.capacity() + sizeof(uint64_t) * block.alive.capacity();
+	}
+
+	usage += raw_.capacity() + packed_.capacity() + sizeof(std::max_align_t) * values_.capacity();
+	usage += sizeof(entity_id) * (ids_.capacity() + gathered_.capacity()) + sizeof(uint32_t) * (slots_.capacity() + owners_.capacity() + touched_.capacity()) + mask_.capacity() + rejected_.capacity();
+
+	return usage;
+}
+
+hibernation_store::size_type hibernation_store::release_(component_locator* world, const entity_id* ids, size_type count) noexcept
+{
+	// First pass: mark the requested entities and collect the blocks holding them,
+	// so each block is decompressed once however its entities are spread in ids.
+	touched_.clear();
+	ids_.clear();
+	owners_.clear();
+
+	for (size_type idx = 0; idx < count; ++idx)
+	{
+		entity_id id = ids[idx];
+		uint32_t index = entity_id_in_range(id) ? block_of_.find(id) : INVALID_BLOCK;
+
+		if (index == INVALID_BLOCK || index == WAKING)
+		{
+			continue;
+		}
+
+		_block& block = blocks_[index];
+
+		if ((block.waking == 0 && !touched_.emplace_back(index)) || !ids_.emplace_back(id))
+		{
+			break;
+		}
+
+		if (!owners_.emplace_back(index))
+		{
+			ids_.pop_back();
+			break;
+		}
+
+		++block.waking;
+		block_of_.set(id, WAKING);
+	}
+
+	size_type released = 0;
+
+	for (uint32_t index : touched_)
+	{
+		_block& block = blocks_[index];
+
+		if (!stage_(raw_, block.raw_size) || !decompress(block.data.data(), block.data.size(), raw_.data(), block.raw_size) || !mask_.resize(block.entity_count))
+		{
+			continue;
+		}
+
+		const entity_id* block_ids = reinterpret_cast<const entity_id*>(raw_.data() + sizeof(_block_header));
+
+		// Only slots still owned by this block: an entity woken from it earlier and
+		// hibernated again elsewhere is marked too, but its copy here is stale.
+		for (size_type slot = 0; slot < block.entity_count; ++slot)
+		{
+			mask_[slot] = block.alive_at(slot) && block_of_.find(block_ids[slot]) == WAKING ? 1 : 0;
+		}
+
+		if (world)
+		{
+			unpack_(*world);
+		}
+
+		size_type woken = 0;
+
+		for (size_type slot = 0; slot < block.entity_count; ++slot)
+		{
+			if (mask_[slot])
+			{
+				block_of_.reset(block_ids[slot]);
+				block.kill(slot);
+				++woken;
+			}
+		}
+
+		block.live -= woken;
+		block.waking = 0;
+
+		size_ -= woken;
+		released += woken;
+
+		if (block.live == 0)
+		{
+			drop_(index);
+		}
+		else if (block.live * 2 <= block.entity_count)
+		{
+			repack_(block);
+		}
+	}
+
+	// Blocks that could not be decompressed, and entities that could not be
+	// reinserted, stay dormant.
+	for (size_t idx = 0; idx < ids_.size(); ++idx)
+	{
+		if (block_of_.find(ids_[idx]) == WAKING)
+		{
+			block_of_.set(ids_[idx], owners_[idx]);
+			blocks_[owners_[idx]].waking = 0;
+		}
+	}
+
+	return released;
+}
+
+void hibernation_store::unpack_(component_locator& world) noexcept
+{
+	// Clears the mask of entities that could not be reinserted with every one of
+	// their components; whatever part of them made it is taken back out.
+	_block_header header;
+	std::memcpy(&header, raw_.data(), sizeof(header));
+
+	const entity_id* block_ids = reinterpret_cast<const entity_id*>(raw_.data() + sizeof(header));
+	size_t offset = sizeof(header) + sizeof(entity_id) * header.entity_count;
+
+	if (!gathered_.resize(header.entity_count) || !slots_.resize(header.entity_count) || !rejected_.resize(header.entity_count))
+	{
+		std::memset(mask_.data(), 0, header.entity_count);
+		return;
+	}
+
+	bool partial = false;
+
+	for (size_type section_idx = 0; section_idx < header.section_count; ++section_idx)
+	{
+		_section_header section;
+		std::memcpy(&section, raw_.data() + offset, sizeof(section));
+		offset += sizeof(section);
+
+		const section_codec& codec = codecs_[section.codec];
+		const std::byte* slots = raw_.data() + offset;
+		const std::byte* values = slots + sizeof(uint32_t) * section.count;
+
+		offset += (sizeof(uint32_t) + codec.value_size) * size_t{ section.count };
+
+		bool staged = stage_values_(size_t{ codec.value_size } * section.count);
+		std::byte* gathered = reinterpret_cast<std::byte*>(values_.data());
+		size_type found = 0;
+
+		for (size_type idx = 0; idx < section.count; ++idx)
+		{
+			uint32_t slot;
+			std::memcpy(&slot, slots + sizeof(uint32_t) * idx, sizeof(slot));
+
+			if (!mask_[slot])
+			{
+				continue;
+			}
+
+			if (!staged)
+			{
+				mask_[slot] = 2;
+				partial = true;
+				continue;
+			}
+
+			gathered_[found] = block_ids[slot];
+			slots_[found] = slot;
+			std::memcpy(gathered + size_t{ codec.value_size } * found, values + size_t{ codec.value_size } * idx, codec.value_size);
+			++found;
+		}
+
+		if (found && codec.insert(world, gathered_.data(), gathered, found, rejected_.data()) < found)
+		{
+			for (size_type idx = 0; idx < found; ++idx)
+			{
+				if (rejected_[idx])
+				{
+					mask_[slots_[idx]] = 2;
+					partial = true;
+				}
+			}
+		}
+	}
+
+	if (!partial)
+	{
+		return;
+	}
+
+	size_type count = 0;
+
+	for (size_type slot = 0; slot < header.entity_count; ++slot)
+	{
+		if (mask_[slot] == 2)
+		{
+			gathered_[count++] = block_ids[slot];
+			mask_[slot] = 0;
+		}
+	}
+
+	for (const section_codec& codec : codecs_)
+	{
+		codec.erase(world, gathered_.data(), count);
+	}
+}
+
+bool hibernation_store::repack_(_block& block) noexcept
+{
+	// Rebuilds the block from the slots still alive, renumbering them.
+	_block_header header;
+	std::memcpy(&header, raw_.data(), sizeof(header));
+
+	const entity_id* block_ids = reinterpret_cast<const entity_id*>(raw_.data() + sizeof(header));
+
+	if (!slots_.resize(header.entity_count))
+	{
+		return false;
+	}
+
+	dynamic_array<std::byte> source = std::move(raw_);
+	_block_header packed { 0, 0 };
+
+	raw_.clear();
+
+	if (!append_(&packed, sizeof(packed)))
+	{
+		raw_ = std::move(source);
+		return false;
+	}
+
+	for (size_type slot = 0; slot < header.entity_count; ++slot)
+	{
+		if (!block.alive_at(slot))
+		{
+			continue;
+		}
+
+		slots_[slot] = packed.entity_count++;
+
+		if (!append_(block_ids + slot, sizeof(entity_id)))
+		{
+			raw_ = std::move(source);
+			return false;
+		}
+	}
+
+	size_t offset = sizeof(header) + sizeof(entity_id) * header.entity_count;
+
+	for (size_type section_idx = 0; section_idx < header.section_count; ++section_idx)
+	{
+		_section_header section;
+		std::memcpy(&section, source.data() + offset, sizeof(section));
+		offset += sizeof(section);
+
+		uint32_t value_size = codecs_[section.codec].value_size;
+		const std::byte* slots = source.data() + offset;
+		const std::byte* values = slots + sizeof(uint32_t) * section.count;
+
+		offset += (sizeof(uint32_t) + value_size) * size_t{ section.count };
+
+		// Slots first, values after, both in a single pass over the section.
+		size_t section_offset = raw_.size();
+		_section_header kept { section.codec, 0 };
+
+		for (size_type idx = 0; idx < section.count; ++idx)
+		{
+			uint32_t slot;
+			std::memcpy(&slot, slots + sizeof(uint32_t) * idx, sizeof(slot));
+			kept.count += block.alive_at(slot) ? 1 : 0;
+		}
+
+		if (kept.count == 0)
+		{
+			continue;
+		}
+
+		if (!stage_(raw_, section_offset + sizeof(kept) + (sizeof(uint32_t) + value_size) * size_t{ kept.count }))
+		{
+			raw_ = std::move(source);
+			return false;
+		}
+
+		std::byte* out_slots = raw_.data() + section_offset + sizeof(kept);
+		std::byte* out_values = out_slots + sizeof(uint32_t) * kept.count;
+		size_type written = 0;
+
+		std::memcpy(raw_.data() + section_offset, &kept, sizeof(kept));
+
+		for (size_type idx = 0; idx < section.count; ++idx)
+		{
+			uint32_t slot;
+			std::memcpy(&slot, slots + sizeof(uint32_t) * idx, sizeof(slot));
+
+			if (!block.alive_at(slot))
+			{
+				continue;
+			}
+
+			std::memcpy(out_slots + sizeof(uint32_t) * written, &slots_[slot], sizeof(uint32_t));
+			std::memcpy(out_values + size_t{ value_size } * written, values + size_t{ value_size } * idx, value_size);
+			++written;
+		}
+
+		++packed.section_count;
+	}
+
+	std::memcpy(raw_.data(), &packed, sizeof(packed));
+
+	dynamic_array<uint64_t> alive;
+
+	if (!fill_alive_(alive, packed.entity_count) || !store_(block))
+	{
+		raw_ = std::move(source);
+		return false;
+	}
+
+	block.alive = std::move(alive);
+	block.entity_count = packed.entity_count;
+	return true;
+}
+
+bool hibernation_store::store_(_block& block) noexcept
+{
+	size_t bound = compress_bound(raw_.size());
+
+	if (!stage_(packed_, bound))
+	{
+		return false;
+	}
+
+	size_t size = compress(raw_.data(), raw_.size(), packed_.data(), bound);
+	dynamic_array<std::byte> data;
+
+	if (size == 0 || !data.assign(packed_.data(), size))
+	{
+		return false;
+	}
+
+	raw_bytes_ += raw_.size() - block.raw_size;
+	compressed_bytes_ += data.size() - block.data.size();
+
+	block.data = std::move(data);
+	block.raw_size = raw_.size();
+
+	return true;
+}
+
+void hibernation_store::drop_(uint32_t index) noexcept
+{
+	_block& block = blocks_[index];
+
+	raw_bytes_ -= block.raw_size;
+	compressed_bytes_ -= block.data.size();
+
+	block.data = {};
+	block.alive = {};
+	block.raw_size = 0;
+	block.entity_count = 0;
+	block.live = 0;
+	block.waking = 0;
+
+	// A slot that cannot be recorded is simply never reused.
+	free_blocks_.emplace_back(index);
+}
+
+uint32_t hibernation_store::acquire_block_() noexcept
+{
+	if (!free_blocks_.empty())
+	{
+		uint32_t index = free_blocks_.back();
+		free_blocks_.pop_back();
+
+		return index;
+	}
+
+	if (blocks_.size() >= WAKING || !blocks_.emplace_back())
+	{
+		return INVALID_BLOCK;
+	}
+
+	return static_cast<uint32_t>(blocks_.size() - 1);
+}
+
+bool hibernation_store::append_(const void* bytes, size_t size) noexcept
+{
+	size_t offset = raw_.size();
+
+	if (!stage_(raw_, offset + size))
+	{
+		return false;
+	}
+
+	std::memcpy(raw_.data() + offset, bytes, size);
+	return true;
+}
+
+bool hibernation_store::stage_values_(size_t bytes) noexcept
+{
+	return values_.resize((bytes + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t));
+}
+
+bool hibernation_store::fill_alive_(dynamic_array<uint64_t>& alive, size_type count) noexcept
+{
+	if (!alive.resize((count + 63) / 64))
+	{
+		return false;
+	}
+
+	std::memset(alive.data(), 0xff, sizeof(uint64_t) * alive.size());
+	return true;
+}
+
+bool hibernation_store::stage_(dynamic_array<std::byte>& buffer, size_t size) noexcept
+{
+	// Doubling keeps repeated appends amortised; resize alone grows to the exact size.
+	if (size > buffer.capacity() && !buffer.reserve(size > 2 * buffer.capacity() ? size : 2 * buffer.capacity()))
+	{
+		return false;
+	}
+
+	return buffer.resize(size);
+}
+
+} // namespace ecs
@@ -0,0 +1,52 @@
+#include "ecs/memory_budget.h"
+
+namespace ecs
+{
+
+memory_budget::memory_budget(size_type limit) noexcept
+	: limit_(limit)
+{
+}
+
+bool memory_budget::try_acquire(size_type bytes) noexcept
+{
+	size_type used = used_.load(std::memory_order_relaxed);
+
+	do
+	{
+		size_type limit = limit_.load(std::memory_order_relaxed);
+
+		if (used > limit || bytes > limit - used)
+		{
+			return false;
+		}
+	}
+	while (!used_.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+
+	return true;
+}
+
+void memory_budget::charge(size_type bytes) noexcept
+{
+	used_.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void memory_budget::release(size_type bytes) noexcept
+{
+	used_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+void memory_budget::set_limit(size_type limit) noexcept
+{
+	limit_.store(limit, std::memory_order_relaxed);
+}
+
+memory_budget::size_type memory_budget::available() const noexcept
+{
+	size_type limit = limit_.load(std::memory_order_relaxed);
+	size_type used = used_.load(std::memory_order_relaxed);
+
+	return used < limit ? limit - used : 0;
+}
+
+} // namespace ecs
@@ -0,0 +1,542 @@
+#include "ecs/runtime_component.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace ecs
+{
+
+namespace
+{
+
+size_t field_width(field_type type) noexcept
+{
+	switch (type)
+	{
+	case field_type::int8:
+	case field_type::uint8:
+	case field_type::bytes:
+		return 1;
+	case field_type::int16:
+	case field_type::uint16:
+		return 2;
+	case field_type::int32:
+	case field_type::uint32:
+	case field_type::float32:
+		return 4;
+	case field_type::int64:
+	case field_type::uint64:
+	case field_type::float64:
+		return 8;
+	case field_type::entity:
+		return sizeof(entity_id);
+	}
+
+	return 0;
+}
+
+} // namespace
+
+runtime_component::runtime_component(const component_descriptor& descriptor) noexcept
+{
+	if (!copy_descriptor_(descriptor))
+	{
+		descriptor_ = {};
+		names_.clear();
+		fields_.clear();
+		stride_ = 0;
+	}
+}
+
+runtime_component::~runtime_component() noexcept
+{
+	detach_observers_();
+
+	for (index_type idx = 0; idx < size_; ++idx)
+	{
+		destroy_(at(idx));
+	}
+
+	if (values_)
+	{
+		deallocate_values_(values_);
+	}
+
+	if (budget_)
+	{
+		budget_->release(memory_usage());
+	}
+}
+
+const component_field* runtime_component::find_field(const char* name) const noexcept
+{
+	if (!name)
+	{
+		return nullptr;
+	}
+
+	for (const component_field& field : fields_)
+	{
+		if (field.name && std::strcmp(field.name, name) == 0)
+		{
+			return &field;
+		}
+	}
+
+	return nullptr;
+}
+
+void* runtime_component::emplace(entity_id id) noexcept
+{
+	index_type idx = find_(id);
+
+	if (idx != INVALID_INDEX)
+	{
+		return at(idx);
+	}
+
+	void* value = insert_(id);
+
+	if (value)
+	{
+		construct_(value);
+		notify_insert_(id);
+	}
+
+	return value;
+}
+
+void* runtime_component::set(entity_id id, const void* value) noexcept
+{
+	if (!value || !copyable())
+	{
+		return nullptr;
+	}
+
+	index_type idx = find_(id);
+
+	if (idx != INVALID_INDEX)
+	{
+		void* dst = at(idx);
+
+		destroy_(dst);
+		copy_(dst, value);
+
+		notify_assign_(id);
+		return dst;
+	}
+
+	void* dst = insert_(id);
+
+	if (dst)
+	{
+		copy_(dst, value);
+		notify_insert_(id);
+	}
+
+	return dst;
+}
+
+void runtime_component::touch(entity_id id) noexcept
+{
+	if (find_(id) != INVALID_INDEX)
+	{
+		notify_assign_(id);
+	}
+}
+
+const void* runtime_component::get(entity_id id) const noexcept
+{
+	index_type idx = find_(id);
+	return idx != INVALID_INDEX ? at(idx) : nullptr;
+}
+
+void* runtime_component::get(entity_id id) noexcept
+{
+	index_type idx = find_(id);
+	return idx != INVALID_INDEX ? at(idx) : nullptr;
+}
+
+bool runtime_component::has(entity_id id) const noexcept
+{
+	return find_(id) != INVALID_INDEX;
+}
+
+void runtime_component::remove(entity_id id) noexcept
+{
+	index_type idx = find_(id);
+
+	if (idx == INVALID_INDEX)
+	{
+		return;
+	}
+
+	notify_erase_(id);
+
+	index_type last = size_ - 1;
+
+	destroy_(at(idx));
+
+	if (idx != last)
+	{
+		relocate_(at(idx), at(last));
+	}
+
+	pop_(idx, id);
+}
+
+void runtime_component::clear() noexcept
+{
+	if (empty())
+	{
+		return;
+	}
+
+	for (index_type idx = 0; idx < size_; ++idx)
+	{
+		destroy_(at(idx));
+	}
+
+	reset_ids_();
+
+	notify_reset_();
+}
+
+bool runtime_component::reserve(size_type capacity) noexcept
+{
+	if (capacity <= capacity_)
+	{
+		return true;
+	}
+
+	if (capacity > MAX_SIZE || !valid())
+	{
+		return false;
+	}
+
+	return reallocate_(capacity);
+}
+
+void runtime_component::shrink_to_fit() noexcept
+{
+	size_t released = index_of_id_.shrink_to_fit();
+
+	if (budget_)
+	{
+		budget_->release(released);
+	}
+
+	if (size_ < capacity_)
+	{
+		reallocate_(size_);
+	}
+}
+
+size_t runtime_component::memory_usage() const noexcept
+{
+	return (size_t{ stride_ } + sizeof(entity_id)) * capacity_ + index_of_id_.memory_usage();
+}
+
+void runtime_component::set_budget(memory_budget* budget) noexcept
+{
+	if (budget_ == budget)
+	{
+		return;
+	}
+
+	if (budget_)
+	{
+		budget_->release(memory_usage());
+	}
+
+	budget_ = budget;
+
+	if (budget_)
+	{
+		budget_->charge(memory_usage());
+	}
+}
+
+bool runtime_component::restore_from(const runtime_component& other) noexcept
+{
+	if (this == &other)
+	{
+		return true;
+	}
+
+	if (!valid() || !copyable() || !same_layout(other))
+	{
+		return false;
+	}
+
+	for (index_type idx = 0; idx < size_; ++idx)
+	{
+		destroy_(at(idx));
+	}
+
+	size_ = 0;
+
+	if (other.size_ > capacity_ && !reallocate_(next_capacity_(other.size_, MAX_SIZE)))
+	{
+		index_of_id_.clear();
+		ids_changed_();
+		notify_reset_();
+		return false;
+	}
+
+	if (!copy_ids_from_(other))
+	{
+		notify_reset_();
+		return false;
+	}
+
+	for (index_type idx = 0; idx < other.size_; ++idx)
+	{
+		copy_(at(idx), other.at(idx));
+	}
+
+	size_ = other.size_;
+
+	notify_reset_();
+	return true;
+}
+
+bool runtime_component::clone_to(runtime_component& other) const noexcept
+{
+	return other.restore_from(*this);
+}
+
+bool runtime_component::same_layout(const runtime_component& other) const noexcept
+{
+	const component_descriptor& a = descriptor_;
+	const component_descriptor& b = other.descriptor_;
+
+	if (a.size != b.size || a.alignment != b.alignment || a.field_count != b.field_count ||
+		a.construct != b.construct || a.copy != b.copy || a.relocate != b.relocate || a.destroy != b.destroy)
+	{
+		return false;
+	}
+
+	for (uint32_t idx = 0; idx < a.field_count; ++idx)
+	{
+		const component_field& x = a.fields[idx];
+		const component_field& y = b.fields[idx];
+
+		if (x.type != y.type || x.offset != y.offset || x.count != y.count)
+		{
+			return false;
+		}
+
+		if ((x.name == nullptr) != (y.name == nullptr) || (x.name && std::strcmp(x.name, y.name) != 0))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool runtime_component::copy_descriptor_(const component_descriptor& descriptor) noexcept
+{
+	uint32_t alignment = descriptor.alignment ? descriptor.alignment : 1;
+
+	if (descriptor.size == 0 || (alignment & (alignment - 1)) != 0 || (descriptor.field_count && !descriptor.fields))
+	{
+		return false;
+	}
+
+	size_t name_bytes = descriptor.name ? std::strlen(descriptor.name) + 1 : 0;
+
+	for (uint32_t idx = 0; idx < descriptor.field_count; ++idx)
+	{
+		const component_field& field = descriptor.fields[idx];
+
+		if (size_t{ field.offset } + field_width(field.type) * field.count > descriptor.size)
+		{
+			return false;
+		}
+
+		name_bytes += field.name ? std::strlen(field.name) + 1 : 0;
+	}
+
+	// Names are packed into one buffer sized up front, so pointers into it stay valid.
+	if (!names_.resize(name_bytes) || !fields_.assign(descriptor.fields, descriptor.field_count))
+	{
+		return false;
+	}
+
+	size_t offset = 0;
+
+	auto copy_name = [this, &offset](const char* name) -> const char*
+	{
+		if (!name)
+		{
+			return nullptr;
+		}
+
+		size_t bytes = std::strlen(name) + 1;
+		char* dst = names_.data() + offset;
+
+		std::memcpy(dst, name, bytes);
+		offset += bytes;
+
+		return dst;
+	};
+
+	descriptor_ = descriptor;
+	descriptor_.alignment = alignment;
+	descriptor_.name = copy_name(descriptor.name);
+	descriptor_.fields = fields_.data();
+
+	for (component_field& field : fields_)
+	{
+		field.name = copy_name(field.name);
+	}
+
+	stride_ = static_cast<size_type>((size_t{ descriptor.size } + alignment - 1) & ~size_t{ alignment - 1 });
+	return true;
+}
+
+runtime_component::index_type runtime_component::find_(entity_id id) const noexcept
+{
+	if (empty() || !entity_id_in_range(id))
+	{
+		return INVALID_INDEX;
+	}
+
+	return dense_set::find_(id);
+}
+
+void* runtime_component::insert_(entity_id id) noexcept
+{
+	if (!valid() || !entity_id_in_range(id))
+	{
+		return nullptr;
+	}
+
+	index_type stale;
+
+	if (!find_stale_(id, stale))
+	{
+		return nullptr;
+	}
+
+	if (stale != INVALID_INDEX)
+	{
+		remove(id_of_index_[stale]);
+	}
+
+	if (size_ >= MAX_SIZE)
+	{
+		return nullptr;
+	}
+
+	if (size_ == capacity_ && !grow_(size_ + 1))
+	{
+		return nullptr;
+	}
+
+	if (!index_of_id_.acquire(id, budget_))
+	{
+		return nullptr;
+	}
+
+	return at(push_(id));
+}
+
+void runtime_component::construct_(void* value) const noexcept
+{
+	if (descriptor_.construct)
+	{
+		descriptor_.construct(value);
+	}
+	else
+	{
+		std::memset(value, 0, descriptor_.size);
+	}
+}
+
+void runtime_component::copy_(void* dst, const void* src) const noexcept
+{
+	if (descriptor_.copy)
+	{
+		descriptor_.copy(dst, src);
+	}
+	else
+	{
+		std::memcpy(dst, src, descriptor_.size);
+	}
+}
+
+void runtime_component::relocate_(void* dst, void* src) const noexcept
+{
+	if (descriptor_.relocate)
+	{
+		descriptor_.relocate(dst, src);
+	}
+	else
+	{
+		std::memcpy(dst, src, descriptor_.size);
+	}
+}
+
+void runtime_component::destroy_(void* value) const noexcept
+{
+	if (descriptor_.destroy)
+	{
+		descriptor_.destroy(value);
+	}
+}
+
+bool runtime_component::grow_(size_type required) noexcept
+{
+	if (reallocate_(next_capacity_(required, MAX_SIZE)))
+	{
+		return true;
+	}
+
+	size_type step = std::max(MIN_CAPACITY, capacity_ / 8);
+	size_type capacity = std::max(required, std::min(capacity_ + step, MAX_SIZE));
+
+	return reallocate_(capacity);
+}
+
+bool runtime_component::reallocate_(size_type capacity) noexcept
+{
+	return dense_set::reallocate_(capacity, stride_, [this](size_type capacity) noexcept
+	{
+		std::byte* values = capacity > 0 ? static_cast<std::byte*>(allocate_values_(capacity)) : nullptr;
+
+		if (capacity > 0 && !values)
+		{
+			return false;
+		}
+
+		for (index_type idx = 0; idx < size_; ++idx)
+		{
+			relocate_(values + size_t{ stride_ } * idx, at(idx));
+		}
+
+		if (values_)
+		{
+			deallocate_values_(values_);
+		}
+
+		values_ = values;
+		return true;
+	});
+}
+
+void* runtime_component::allocate_values_(size_type capacity) const noexcept
+{
+	return ::operator new(size_t{ stride_ } * capacity, std::align_val_t{ descriptor_.alignment }, std::nothrow);
+}
+
+void runtime_component::deallocate_values_(void* values) const noexcept
+{
+	::operator delete(values, std::align_val_t{ descriptor_.alignment }, std::nothrow);
+}
+
+} // namespace ecs
@@ -0,0 +1,343 @@
+#include "ecs/sharded_world.h"
+#include "ecs/default_allocator.h"
+
+#include <cstring>
+#include <memory>
+#include <utility>
+
+namespace ecs
+{
+
+sharded_world::sharded_world(size_type shard_count) noexcept
+{
+	if (shard_count == 0 || shard_count > MAX_SHARDS)
+	{
+		return;
+	}
+
+	size_t channel_count = size_t{ shard_count } * shard_count;
+
+	_shard* shards = default_allocator<_shard>{}.allocate(shard_count);
+	_channel* channels = default_allocator<_channel>{}.allocate(channel_count);
+
+	if (!shards || !channels)
+	{
+		if (shards)
+		{
+			default_allocator<_shard>{}.deallocate(shards, shard_count);
+		}
+
+		if (channels)
+		{
+			default_allocator<_channel>{}.deallocate(channels, channel_count);
+		}
+
+		return;
+	}
+
+	for (size_type idx = 0; idx < shard_count; ++idx)
+	{
+		std::construct_at(shards + idx);
+	}
+
+	for (size_t idx = 0; idx < channel_count; ++idx)
+	{
+		std::construct_at(channels + idx);
+	}
+
+	shards_ = shards;
+	channels_ = channels;
+	shard_count_ = shard_count;
+}
+
+sharded_world::~sharded_world() noexcept
+{
+	stop();
+
+	if (!shards_)
+	{
+		return;
+	}
+
+	size_t channel_count = size_t{ shard_count_ } * shard_count_;
+
+	std::destroy_n(channels_, channel_count);
+	default_allocator<_channel>{}.deallocate(channels_, channel_count);
+
+	std::destroy_n(shards_, shard_count_);
+	default_allocator<_shard>{}.deallocate(shards_, shard_count_);
+}
+
+sharded_world::size_type sharded_world::shard_of(entity_id id) const noexcept
+{
+	size_type shard = (partition_ ? partition_ : &default_partition_)(id, shard_count_, partition_context_);
+	return shard < shard_count_ ? shard : shard_count_ - 1;
+}
+
+void sharded_world::set_partition(partition_fn fn, void* context) noexcept
+{
+	partition_ = fn;
+	partition_context_ = context;
+}
+
+bool sharded_world::start()
+{
+	if (running() || !valid() || !threads_.reserve(shard_count_))
+	{
+		return false;
+	}
+
+	stopping_ = false;
+
+	for (size_type idx = 0; idx < shard_count_; ++idx)
+	{
+		std::thread thread(&sharded_world::worker_, this, idx, generation_);
+		threads_.emplace_back(std::move(thread));
+	}
+
+	return true;
+}
+
+void sharded_world::stop() noexcept
+{
+	if (!running())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard lock(mutex_);
+		stopping_ = true;
+	}
+
+	wake_.notify_all();
+
+	for (std::thread& thread : threads_)
+	{
+		thread.join();
+	}
+
+	threads_.clear();
+}
+
+void sharded_world::set_tick(tick_fn fn, void* context) noexcept
+{
+	tick_ = fn;
+	tick_context_ = context;
+}
+
+void sharded_world::tick(float delta_time) noexcept
+{
+	if (!valid())
+	{
+		return;
+	}
+
+	flip_();
+	delta_time_ = delta_time;
+
+	_job job {};
+
+	job.context = this;
+	job.run = [](void*, sharded_world& world, size_type shard)
+	{
+		world.apply_migrations_(shard);
+
+		if (world.tick_)
+		{
+			world.tick_(world.shard(shard), shard, world.delta_time_, world.tick_context_);
+		}
+	};
+
+	dispatch_(job);
+}
+
+sharded_world::size_type sharded_world::migrate(size_type from, size_type to, const entity_id* ids, size_type count) noexcept
+{
+	if (from >= shard_count_ || to >= shard_count_ || from == to || count == 0)
+	{
+		return 0;
+	}
+
+	_shard& source = shards_[from];
+	_stream& stream = channels_[size_t{ from } * shard_count_ + to].write;
+
+	size_t value_size = 0;
+
+	for (const section_codec& codec : codecs_)
+	{
+		value_size = codec.value_size > value_size ? codec.value_size : value_size;
+	}
+
+	if (!source.ids.resize(count) || !source.values.resize((value_size * count + ALIGNMENT - 1) / ALIGNMENT))
+	{
+		return 0;
+	}
+
+	size_type moved = 0;
+
+	for (uint32_t codec = 0; codec < codecs_.size(); ++codec)
+	{
+		const section_codec& entry = codecs_[codec];
+		size_type found = entry.extract(source.world, ids, count, source.ids.data(), source.values.data());
+
+		if (found == 0)
+		{
+			continue;
+		}
+
+		size_t ids_offset = stream.size + align_(sizeof(_section_header));
+		size_t values_offset = ids_offset + align_(sizeof(entity_id) * found);
+		size_t end = values_offset + align_(size_t{ entry.value_size } * found);
+
+		if (!reserve_(stream, end))
+		{
+			// Back where they came from rather than lost.
+			entry.insert(source.world, source.ids.data(), source.values.data(), found, nullptr);
+			failed_.fetch_add(found, std::memory_order_relaxed);
+			continue;
+		}
+
+		_section_header section { codec, found };
+		std::byte* bytes = bytes_(stream);
+
+		std::memcpy(bytes + stream.size, &section, sizeof(section));
+		std::memcpy(bytes + ids_offset, source.ids.data(), sizeof(entity_id) * found);
+		std::memcpy(bytes + values_offset, source.values.data(), size_t{ entry.value_size } * found);
+
+		stream.size = end;
+		moved += found;
+	}
+
+	return moved;
+}
+
+void sharded_world::dispatch_(_job job) noexcept
+{
+	if (!running())
+	{
+		for (size_type shard = 0; shard < shard_count_; ++shard)
+		{
+			job.run(job.context, *this, shard);
+		}
+
+		return;
+	}
+
+	{
+		std::lock_guard lock(mutex_);
+
+		job_ = job;
+		remaining_.store(shard_count_, std::memory_order_relaxed);
+		++generation_;
+	}
+
+	wake_.notify_all();
+
+	std::unique_lock lock(mutex_);
+	done_.wait(lock, [this] { return remaining_.load(std::memory_order_acquire) == 0; });
+}
+
+void sharded_world::worker_(size_type shard, uint64_t generation) noexcept
+{
+	for (;;)
+	{
+		_job job;
+
+		{
+			std::unique_lock lock(mutex_);
+			wake_.wait(lock, [this, generation] { return stopping_ || generation_ != generation; });
+
+			if (stopping_)
+			{
+				return;
+			}
+
+			generation = generation_;
+			job = job_;
+		}
+
+		job.run(job.context, *this, shard);
+
+		if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+		{
+			std::lock_guard lock(mutex_);
+			done_.notify_one();
+		}
+	}
+}
+
+void sharded_world::flip_() noexcept
+{
+	for (size_type shard = 0; shard < shard_count_; ++shard)
+	{
+		shards_[shard].inbox.swap();
+	}
+
+	size_t channel_count = size_t{ shard_count_ } * shard_count_;
+
+	for (size_t idx = 0; idx < channel_count; ++idx)
+	{
+		_channel& channel = channels_[idx];
+
+		std::swap(channel.write, channel.read);
+		channel.write.size = 0;
+	}
+}
+
+void sharded_world::apply_migrations_(size_type shard) noexcept
+{
+	component_locator& world = shards_[shard].world;
+
+	for (size_type from = 0; from < shard_count_; ++from)
+	{
+		_stream& stream = channels_[size_t{ from } * shard_count_ + shard].read;
+		const std::byte* bytes = bytes_(stream);
+
+		for (size_t offset = 0; offset < stream.size;)
+		{
+			_section_header section;
+			std::memcpy(&section, bytes + offset, sizeof(section));
+
+			const section_codec& codec = codecs_[section.codec];
+
+			size_t ids_offset = offset + align_(sizeof(_section_header));
+			size_t values_offset = ids_offset + align_(sizeof(entity_id) * section.count);
+
+			size_type inserted = codec.insert(world, reinterpret_cast<const entity_id*>(bytes + ids_offset), bytes + values_offset, section.count, nullptr);
+
+			// The source has already let go of them and is ticking concurrently, so
+			// they cannot go back; they are only counted.
+			if (inserted < section.count)
+			{
+				failed_.fetch_add(section.count - inserted, std::memory_order_relaxed);
+			}
+
+			offset = values_offset + align_(size_t{ codec.value_size } * section.count);
+		}
+	}
+}
+
+bool sharded_world::reserve_(_stream& stream, size_t size) noexcept
+{
+	size_t units = (size + ALIGNMENT - 1) / ALIGNMENT;
+
+	if (units <= stream.data.size())
+	{
+		return true;
+	}
+
+	if (units > stream.data.capacity() && !stream.data.reserve(units > 2 * stream.data.capacity() ? units : 2 * stream.data.capacity()))
+	{
+		return false;
+	}
+
+	return stream.data.resize(units);
+}
+
+sharded_world::size_type sharded_world::default_partition_(entity_id id, size_type shard_count, void*) noexcept
+{
+	return static_cast<size_type>(uint64_t{ entity_index(id) } * shard_count / MAX_ENTITY_COUNT);
+}
+
+} // namespace ecs
@@ -0,0 +1,52 @@
+#include "ecs/thread_slot.h"
+
+#include <atomic>
+#include <bit>
+
+namespace ecs
+{
+
+namespace
+{
+
+std::atomic<uint64_t> used_slots = 0;
+
+struct slot_owner
+{
+	uint32_t slot = THREAD_SLOT_COUNT;
+
+	slot_owner() noexcept
+	{
+		uint64_t used = used_slots.load(std::memory_order_relaxed);
+
+		// Lowest free slot first, so lanes of exited threads are the first reused.
+		while (used != ~uint64_t{ 0 })
+		{
+			uint32_t free = static_cast<uint32_t>(std::countr_one(used));
+
+			if (used_slots.compare_exchange_weak(used, used | uint64_t{ 1 } << free, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				slot = free;
+				break;
+			}
+		}
+	}
+
+	~slot_owner() noexcept
+	{
+		if (slot < THREAD_SLOT_COUNT)
+		{
+			used_slots.fetch_and(~(uint64_t{ 1 } << slot), std::memory_order_release);
+		}
+	}
+};
+
+} // namespace
+
+uint32_t thread_slot() noexcept
+{
+	static thread_local slot_owner owner;
+	return owner.slot;
+}
+
+} // namespace ecs
@@ -0,0 +1,566 @@
+#include "ecs/world_streamer.h"
+#include "ecs/default_allocator.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <utility>
+
+namespace ecs
+{
+
+namespace
+{
+
+struct _file_header
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t section_count;
+	uint32_t id_size;
+};
+
+struct _section_header
+{
+	uint64_t key;
+	uint32_t value_size;
+	uint32_t count;
+};
+
+struct _file_closer
+{
+	void operator()(std::FILE* file) const noexcept { std::fclose(file); }
+};
+
+using _file_ptr = std::unique_ptr<std::FILE, _file_closer>;
+
+} // namespace
+
+void world_streamer::_queue::push(_batch* batch) noexcept
+{
+	batch->next = nullptr;
+
+	if (tail)
+	{
+		tail->next = batch;
+	}
+	else
+	{
+		head = batch;
+	}
+
+	tail = batch;
+}
+
+world_streamer::_batch* world_streamer::_queue::pop() noexcept
+{
+	_batch* batch = head;
+
+	if (batch)
+	{
+		head = batch->next;
+
+		if (!head)
+		{
+			tail = nullptr;
+		}
+
+		batch->next = nullptr;
+	}
+
+	return batch;
+}
+
+world_streamer::~world_streamer() noexcept
+{
+	stop();
+
+	for (_queue* queue : { &jobs_, &ready_, &free_ })
+	{
+		while (_batch* batch = queue->pop())
+		{
+			destroy_batch_(batch);
+		}
+	}
+
+	if (committing_)
+	{
+		destroy_batch_(committing_);
+	}
+}
+
+bool world_streamer::start(size_type thread_count)
+{
+	if (running() || thread_count == 0 || !threads_.reserve(thread_count))
+	{
+		return false;
+	}
+
+	stopping_ = false;
+
+	for (size_type idx = 0; idx < thread_count; ++idx)
+	{
+		std::thread thread(&world_streamer::worker_, this);
+		threads_.emplace_back(std::move(thread));
+	}
+
+	return true;
+}
+
+void world_streamer::stop() noexcept
+{
+	if (!running())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard lock(mutex_);
+		stopping_ = true;
+	}
+
+	wake_.notify_all();
+
+	for (std::thread& thread : threads_)
+	{
+		thread.join();
+	}
+
+	threads_.clear();
+}
+
+bool world_streamer::load(const char* path) noexcept
+{
+	if (!running())
+	{
+		return false;
+	}
+
+	_batch* batch = acquire_batch_();
+
+	if (!batch)
+	{
+		return false;
+	}
+
+	batch->job = _job::load;
+
+	if (!assign_path_(*batch, path))
+	{
+		release_batch_(batch);
+		return false;
+	}
+
+	pending_.fetch_add(1, std::memory_order_relaxed);
+
+	{
+		std::lock_guard lock(mutex_);
+		jobs_.push(batch);
+	}
+
+	wake_.notify_one();
+	return true;
+}
+
+world_streamer::size_type world_streamer::unload(component_locator& world, const entity_id* ids, size_type count, const char* path) noexcept
+{
+	if (!running() || count == 0)
+	{
+		return 0;
+	}
+
+	_batch* batch = acquire_batch_();
+
+	if (!batch)
+	{
+		return 0;
+	}
+
+	batch->job = _job::store;
+
+	if (!assign_path_(*batch, path) || !batch->sections.reserve(codecs_.size()))
+	{
+		release_batch_(batch);
+		return 0;
+	}
+
+	size_type extracted = 0;
+
+	for (const _codec& codec : codecs_)
+	{
+		_section section {};
+
+		section.key = codec.key;
+		section.value_size = codec.value_size;
+
+		size_t rollback = batch->data.size();
+
+		if (!append_(*batch, sizeof(entity_id) * count, section.ids_offset) || !append_(*batch, size_t{ codec.value_size } * count, section.values_offset))
+		{
+			batch->data.resize(rollback);
+			failed_.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
+
+		std::byte* data = batch->data.data();
+
+		section.count = codec.extract(world, ids, count, reinterpret_cast<entity_id*>(data + section.ids_offset), data + section.values_offset);
+
+		if (section.count == 0)
+		{
+			batch->data.resize(rollback);
+			continue;
+		}
+
+		// Values were packed right after the first `count` ids; move them down so
+		// the section has no gap before it is written out.
+		if (section.count < count)
+		{
+			size_t values_offset = section.ids_offset + sizeof(entity_id) * section.count;
+			values_offset = (values_offset + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+
+			std::memmove(data + values_offset, data + section.values_offset, size_t{ section.value_size } * section.count);
+			section.values_offset = values_offset;
+			batch->data.resize(values_offset + size_t{ section.value_size } * section.count);
+		}
+
+		extracted += section.count;
+		batch->sections.emplace_back(section);
+	}
+
+	if (batch->sections.empty())
+	{
+		release_batch_(batch);
+		return 0;
+	}
+
+	pending_.fetch_add(1, std::memory_order_relaxed);
+
+	{
+		std::lock_guard lock(mutex_);
+		jobs_.push(batch);
+	}
+
+	wake_.notify_one();
+	return extracted;
+}
+
+world_streamer::size_type world_streamer::commit(component_locator& world, clock_type::duration budget) noexcept
+{
+	const clock_type::time_point deadline = clock_type::now() + budget;
+	size_type committed = 0;
+	bool progressed = false;
+
+	do
+	{
+		if (!committing_)
+		{
+			std::lock_guard lock(mutex_);
+			committing_ = ready_.pop();
+
+			if (!committing_)
+			{
+				break;
+			}
+		}
+
+		_batch& batch = *committing_;
+
+		// At least one chunk is committed per call so a tiny budget still makes progress.
+		while (batch.section < batch.sections.size() && (!progressed || clock_type::now() < deadline))
+		{
+			const _section& section = batch.sections[batch.section];
+			const _codec* codec = find_codec_(section.key);
+
+			if (!codec || codec->value_size != section.value_size)
+			{
+				failed_.fetch_add(1, std::memory_order_relaxed);
+				++batch.section;
+				batch.offset = 0;
+				continue;
+			}
+
+			size_type chunk = std::min(COMMIT_CHUNK, section.count - batch.offset);
+
+			const std::byte* data = batch.data.data();
+			const entity_id* ids = reinterpret_cast<const entity_id*>(data + section.ids_offset) + batch.offset;
+			const std::byte* values = data + section.values_offset + size_t{ section.value_size } * batch.offset;
+
+			size_type inserted = codec->insert(world, ids, values, chunk, nullptr);
+
+			committed += inserted;
+			failed_.fetch_add(chunk - inserted, std::memory_order_relaxed);
+			batch.offset += chunk;
+			progressed = true;
+
+			if (batch.offset == section.count)
+			{
+				++batch.section;
+				batch.offset = 0;
+			}
+		}
+
+		if (batch.section < batch.sections.size())
+		{
+			break;
+		}
+
+		release_batch_(std::exchange(committing_, nullptr));
+		pending_.fetch_sub(1, std::memory_order_release);
+	}
+	while (clock_type::now() < deadline);
+
+	return committed;
+}
+
+const world_streamer::_codec* world_streamer::find_codec_(key_type key) const noexcept
+{
+	for (const _codec& codec : codecs_)
+	{
+		if (codec.key == key)
+		{
+			return &codec;
+		}
+	}
+
+	return nullptr;
+}
+
+world_streamer::_batch* world_streamer::acquire_batch_() noexcept
+{
+	{
+		std::lock_guard lock(mutex_);
+
+		if (_batch* batch = free_.pop())
+		{
+			return batch;
+		}
+	}
+
+	_batch* batch = default_allocator<_batch>{}.allocate(1);
+
+	return batch ? std::construct_at(batch) : nullptr;
+}
+
+void world_streamer::release_batch_(_batch* batch) noexcept
+{
+	batch->path.clear();
+	batch->data.clear();
+	batch->sections.clear();
+	batch->section = 0;
+	batch->offset = 0;
+
+	std::lock_guard lock(mutex_);
+	free_.push(batch);
+}
+
+void world_streamer::destroy_batch_(_batch* batch) noexcept
+{
+	std::destroy_at(batch);
+	default_allocator<_batch>{}.deallocate(batch, 1);
+}
+
+bool world_streamer::assign_path_(_batch& batch, const char* path) noexcept
+{
+	return path && batch.path.assign(path, std::strlen(path) + 1);
+}
+
+bool world_streamer::append_(_batch& batch, size_t bytes, size_t& offset) noexcept
+{
+	offset = (batch.data.size() + DATA_ALIGNMENT - 1) & ~(DATA_ALIGNMENT - 1);
+
+	if (offset + bytes > batch.data.capacity() && !batch.data.reserve(std::max(offset + bytes, batch.data.capacity() * 2)))
+	{
+		return false;
+	}
+
+	return batch.data.resize(offset + bytes);
+}
+
+void world_streamer::worker_() noexcept
+{
+	for (;;)
+	{
+		_batch* batch = nullptr;
+
+		{
+			std::unique_lock lock(mutex_);
+			wake_.wait(lock, [this] { return stopping_ || jobs_.head; });
+
+			// Pending stores are still flushed on stop so evicted entities are never lost.
+			batch = jobs_.pop();
+
+			if (!batch)
+			{
+				return;
+			}
+		}
+
+		if (batch->job == _job::load)
+		{
+			finish_(batch, read_(*batch));
+		}
+		else
+		{
+			finish_(batch, write_(*batch));
+		}
+	}
+}
+
+void world_streamer::finish_(_batch* batch, bool succeeded) noexcept
+{
+	if (!succeeded)
+	{
+		failed_.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	// A store that could not be written goes to commit() like a load, which puts
+	// its entities back into the world instead of dropping them.
+	bool commit = batch->job == _job::load ? succeeded : !succeeded;
+
+	if (commit)
+	{
+		std::lock_guard lock(mutex_);
+		ready_.push(batch);
+		return;
+	}
+
+	release_batch_(batch);
+	pending_.fetch_sub(1, std::memory_order_release);
+}
+
+bool world_streamer::read_(_batch& batch) noexcept
+{
+	_file_ptr file(std::fopen(batch.path.data(), "rb"));
+
+	if (!file)
+	{
+		return false;
+	}
+
+	if (std::fseek(file.get(), 0, SEEK_END) != 0)
+	{
+		return false;
+	}
+
+	long file_size = std::ftell(file.get());
+
+	if (file_size < 0 || std::fseek(file.get(), 0, SEEK_SET) != 0)
+	{
+		return false;
+	}
+
+	_file_header header {};
+
+	if (std::fread(&header, sizeof(header), 1, file.get()) != 1 || header.magic != FORMAT_MAGIC || header.version != FORMAT_VERSION || header.id_size != sizeof(entity_id))
+	{
+		return false;
+	}
+
+	// The header's section count and every section are checked against the bytes
+	// actually left in the file before anything is allocated for them, so a corrupt
+	// count cannot ask for gigabytes.
+	size_t remaining = static_cast<size_t>(file_size) - sizeof(header);
+
+	if (header.section_count > remaining / sizeof(_section_header) || !batch.sections.reserve(header.section_count))
+	{
+		return false;
+	}
+
+	for (uint32_t idx = 0; idx < header.section_count; ++idx)
+	{
+		_section_header section_header {};
+
+		if (std::fread(&section_header, sizeof(section_header), 1, file.get()) != 1)
+		{
+			return false;
+		}
+
+		_section section {};
+
+		section.key = section_header.key;
+		section.value_size = section_header.value_size;
+		section.count = section_header.count;
+
+		size_t ids_bytes = sizeof(entity_id) * section.count;
+		size_t values_bytes = size_t{ section.value_size } * section.count;
+
+		size_t section_bytes = sizeof(section_header) + ids_bytes + values_bytes;
+
+		if (section.count > MAX_ENTITY_COUNT || section_bytes > remaining)
+		{
+			return false;
+		}
+
+		remaining -= section_bytes;
+
+		if (!append_(batch, ids_bytes, section.ids_offset) || !append_(batch, values_bytes, section.values_offset))
+		{
+			return false;
+		}
+
+		if (std::fread(batch.data.data() + section.ids_offset, 1, ids_bytes, file.get()) != ids_bytes ||
+			std::fread(batch.data.data() + section.values_offset, 1, values_bytes, file.get()) != values_bytes)
+		{
+			return false;
+		}
+
+		const entity_id* ids = reinterpret_cast<const entity_id*>(batch.data.data() + section.ids_offset);
+
+		if (!std::all_of(ids, ids + section.count, [](entity_id id) { return entity_id_in_range(id); }))
+		{
+			return false;
+		}
+
+		batch.sections.emplace_back(section);
+	}
+
+	// Trailing bytes mean the header and the sections do not describe this file.
+	return remaining == 0;
+}
+
+bool world_streamer::write_(const _batch& batch) noexcept
+{
+	_file_ptr file(std::fopen(batch.path.data(), "wb"));
+
+	if (!file)
+	{
+		return false;
+	}
+
+	_file_header header { FORMAT_MAGIC, FORMAT_VERSION, static_cast<uint32_t>(batch.sections.size()), sizeof(entity_id) };
+
+	if (std::fwrite(&header, sizeof(header), 1, file.get()) != 1)
+	{
+		return false;
+	}
+
+	for (const _section& section : batch.sections)
+	{
+		_section_header section_header { section.key, section.value_size, section.count };
+
+		size_t ids_bytes = sizeof(entity_id) * section.count;
+		size_t values_bytes = size_t{ section.value_size } * section.count;
+
+		if (std::fwrite(&section_header, sizeof(section_header), 1, file.get()) != 1 ||
+			std::fwrite(batch.data.data() + section.ids_offset, 1, ids_bytes, file.get()) != ids_bytes ||
+			std::fwrite(batch.data.data() + section.values_offset, 1, values_bytes, file.get()) != values_bytes)
+		{
+			file.reset();
+			std::remove(batch.path.data());
+			return false;
+		}
+	}
+
+	if (std::fflush(file.get()) != 0)
+	{
+		file.reset();
+		std::remove(batch.path.data());
+		return false;
+	}
+
+	return true;
+}
+
+} // namespace ecs
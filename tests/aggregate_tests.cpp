@@ -0,0 +1,84 @@
+#include "test.h"
+
+#include "ecs/ecs.h"
+
+using namespace ecs;
+
+namespace
+{
+
+struct score
+{
+	int value = 0;
+};
+
+struct score_component final : abstract_component<score>
+{
+};
+
+struct tag
+{
+	int value = 0;
+};
+
+// Lets a test deliver an erase notification for a handle the pool no longer holds.
+struct tag_component final : abstract_component<tag>
+{
+	void announce_erase(entity_id id) noexcept { notify_erase_(id); }
+};
+
+struct score_value
+{
+	int operator()(const score& s) const noexcept { return s.value; }
+};
+
+} // namespace
+
+TEST(aggregate_tracks_removals)
+{
+	score_component pool;
+
+	for (entity_id id = 1; id <= 100; ++id)
+	{
+		pool.set(id, score{ int(id) });
+	}
+
+	aggregate<score_component, score_value> scores(&pool);
+
+	CHECK(scores.min() == 1 && scores.max() == 100 && scores.sum() == 5050);
+
+	pool.remove(1);
+	pool.remove(100);
+
+	CHECK(scores.min() == 2 && scores.max() == 99 && scores.count() == 98);
+	CHECK(scores.verify());
+}
+
+TEST(aggregate_ignores_stale_erase)
+{
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		score_component pool;
+		tag_component tags;
+
+		for (uint32_t idx = 1; idx <= 10; ++idx)
+		{
+			pool.set(make_entity_id(idx, 1), score{ int(idx) });
+			tags.set(make_entity_id(idx, 1), tag{});
+		}
+
+		aggregate<score_component, score_value, tag_component> scores(&pool, &tags);
+
+		CHECK(scores.count() == 10 && scores.sum() == 55);
+
+		tags.announce_erase(make_entity_id(5, 0));
+
+		CHECK(scores.count() == 10 && scores.sum() == 55);
+		CHECK(scores.verify());
+
+		tags.remove(make_entity_id(5, 1));
+
+		CHECK(scores.count() == 9 && scores.sum() == 50);
+		CHECK(scores.verify());
+	}
+}
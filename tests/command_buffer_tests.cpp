@@ -0,0 +1,37 @@
+#include "test.h"
+
+#include "ecs/ecs.h"
+
+using namespace ecs;
+
+namespace
+{
+
+struct anchor
+{
+	explicit anchor(int v) noexcept : value(v) {}
+
+	int value;
+};
+
+struct anchor_component final : abstract_component<anchor>
+{
+};
+
+} // namespace
+
+TEST(set_replays_values_without_default_constructor)
+{
+	entity_id_allocator ids(100);
+	command_buffer commands(&ids);
+	component_locator world;
+
+	entity_id id = commands.create();
+
+	CHECK(commands.set<anchor_component>(id, anchor{ 7 }));
+	CHECK(commands.flush(world) > 0);
+
+	anchor_component* pool = world.get<anchor_component>();
+
+	CHECK(pool && pool->get(id) && pool->get(id)->value == 7);
+}
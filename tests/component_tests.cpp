@@ -0,0 +1,187 @@
+#include "test.h"
+
+#include "ecs/ecs.h"
+
+using namespace ecs;
+
+namespace
+{
+
+struct health
+{
+	int value = 0;
+};
+
+struct health_component final : abstract_component<health>
+{
+};
+
+struct armor
+{
+	int value = 0;
+};
+
+struct armor_component final : abstract_component<armor>
+{
+};
+
+struct frame_value
+{
+	int value = 0;
+};
+
+struct frame_component final : double_buffered_component<frame_value>
+{
+};
+
+} // namespace
+
+TEST(restore_copies_ids_and_values)
+{
+	health_component source;
+
+	for (entity_id id = 0; id < 1000; ++id)
+	{
+		source.set(id, health{ int(id) });
+	}
+
+	for (entity_id id = 0; id < 1000; id += 3)
+	{
+		source.remove(id);
+	}
+
+	memory_budget budget(1 << 20);
+	health_component copy;
+
+	copy.set_budget(&budget);
+	copy.set(5000, health{ 1 });
+
+	CHECK(copy.restore_from(source));
+	CHECK(copy.size() == source.size());
+	CHECK(!copy.has(5000));
+	CHECK(budget.used() == copy.memory_usage());
+
+	for (entity_id id = 0; id < 1000; ++id)
+	{
+		CHECK(copy.has(id) == (id % 3 != 0));
+	}
+
+	CHECK(copy.get(500)->value == 500);
+}
+
+TEST(fill_keeps_existing_components)
+{
+	component_locator world;
+	health_component* pool = world.add<health_component>();
+
+	int inserts = 0;
+	component_observer observer {};
+
+	observer.context = &inserts;
+	observer.on_insert = [](void* context, entity_id) { ++*static_cast<int*>(context); };
+
+	pool->subscribe(observer);
+	pool->set(5, health{ 99 });
+
+	prefab<health_component, armor_component> spawn(health{ 1 }, armor{ 2 });
+	entity_range range = spawn.instantiate(world, 0, 100);
+
+	CHECK(range.count == 100);
+	CHECK(pool->size() == 100);
+	CHECK(pool->get(5)->value == 99);
+	CHECK(pool->get(6)->value == 1);
+	CHECK(world.get<armor_component>()->get(5)->value == 2);
+	CHECK(inserts == 100);
+}
+
+TEST(older_generation_does_not_evict)
+{
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		health_component pool;
+
+		CHECK(pool.set(make_entity_id(5, 1), health{ 10 }) != nullptr);
+		CHECK(pool.set(make_entity_id(5, 0), health{ 20 }) == nullptr);
+		CHECK(pool.get(make_entity_id(5, 1))->value == 10);
+		CHECK(pool.size() == 1);
+
+		CHECK(pool.set(make_entity_id(5, 2), health{ 30 }) != nullptr);
+		CHECK(!pool.has(make_entity_id(5, 1)));
+		CHECK(pool.size() == 1);
+
+		// Generations are ordered modulo wrap-around.
+		CHECK(pool.set(make_entity_id(6, 0xffffffffu), health{ 1 }) != nullptr);
+		CHECK(pool.set(make_entity_id(6, 0), health{ 2 }) != nullptr);
+		CHECK(pool.size() == 2);
+	}
+}
+
+TEST(double_buffer_keeps_previous_frame)
+{
+	frame_component pool;
+
+	for (entity_id id = 1; id <= 10; ++id)
+	{
+		pool.set(id, frame_value{ int(id) });
+	}
+
+	CHECK(pool.swap_buffers());
+
+	auto view = pool.previous();
+
+	pool.remove(3);
+	pool.get(5)->value = 55;
+
+	for (entity_id id = 200; id < 1200; ++id)
+	{
+		pool.set(id, frame_value{ 1 });
+	}
+
+	CHECK(view.size() == 10);
+
+	for (uint32_t idx = 0; idx < view.size(); ++idx)
+	{
+		CHECK(view.ids[idx] == idx + 1);
+		CHECK(view.values[idx].value == int(idx + 1));
+	}
+
+	CHECK(pool.swap_buffers());
+	CHECK(pool.previous().size() == pool.size());
+	CHECK(pool.get(5)->value == 55);
+}
+
+TEST(restore_sparse_source_with_page_gap)
+{
+	health_component source;
+
+	source.set(0, health{ 1 });
+	source.set(99 * 4096 + 1, health{ 2 });
+
+	health_component copy;
+
+	CHECK(copy.restore_from(source));
+	CHECK(copy.size() == 2);
+	CHECK(copy.get(0)->value == 1);
+	CHECK(copy.get(99 * 4096 + 1)->value == 2);
+	CHECK(!copy.has(50 * 4096));
+}
+
+TEST(get_unvalidated_matches_get)
+{
+	frame_component pool;
+
+	for (entity_id id = 1; id <= 10; ++id)
+	{
+		pool.set(id, frame_value{ int(id) });
+	}
+
+	CHECK(pool.swap_buffers());
+
+	// The first access after a swap brings the back buffer up to date.
+	CHECK(pool.get_unvalidated(4)->value == 4);
+	CHECK(pool.get_unvalidated(4) == pool.get(4));
+
+	const frame_component& readonly = pool;
+
+	CHECK(readonly.get_unvalidated(10) == readonly.get(10));
+}
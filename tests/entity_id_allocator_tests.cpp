@@ -0,0 +1,77 @@
+#include "test.h"
+
+#include "ecs/ecs.h"
+
+#include <thread>
+#include <vector>
+
+using namespace ecs;
+
+TEST(failed_reservation_keeps_remaining_ids)
+{
+	entity_id_allocator ids(1000);
+
+	CHECK(ids.allocate(900).count == 900);
+	CHECK(ids.allocate(200).empty());
+	CHECK(ids.allocate(50).count == 50);
+
+	// Fewer than BLOCK_SIZE left: single allocations still drain them.
+	int allocated = 0;
+
+	while (ids.allocate() != INVALID_ENTITY_ID)
+	{
+		++allocated;
+	}
+
+	CHECK(allocated == 50);
+}
+
+TEST(double_release_is_ignored)
+{
+	entity_id_allocator ids(100);
+
+	entity_id first = ids.allocate();
+
+	ids.release(first);
+	ids.release(first);
+
+	entity_id again = ids.allocate();
+	entity_id next = ids.allocate();
+
+	CHECK(entity_index(again) == entity_index(first));
+	CHECK(entity_index(next) != entity_index(again));
+}
+
+TEST(release_ignores_ids_never_handed_out)
+{
+	entity_id_allocator ids(1000);
+
+	CHECK(ids.allocate() != INVALID_ENTITY_ID);
+
+	ids.release(make_entity_id(600));
+
+	std::vector<bool> seen(1000, false);
+	int duplicates = 0;
+	int allocated = 1;
+
+	for (entity_id id = ids.allocate(); id != INVALID_ENTITY_ID; id = ids.allocate())
+	{
+		duplicates += seen[entity_index(id)] ? 1 : 0;
+		seen[entity_index(id)] = true;
+		++allocated;
+	}
+
+	CHECK(duplicates == 0);
+	CHECK(allocated == 1000);
+}
+
+TEST(thread_slots_are_recycled)
+{
+	for (int idx = 0; idx < 200; ++idx)
+	{
+		uint32_t slot = THREAD_SLOT_COUNT;
+
+		std::thread([&slot] { slot = thread_slot(); }).join();
+		CHECK(slot < THREAD_SLOT_COUNT);
+	}
+}
@@ -0,0 +1,55 @@
+#include "test.h"
+
+#include "ecs/ecs.h"
+
+#include <thread>
+
+using namespace ecs;
+
+namespace
+{
+
+struct hit
+{
+	int damage = 0;
+};
+
+struct unregistered_event
+{
+	int value = 0;
+};
+
+} // namespace
+
+TEST(emit_requires_registered_queue)
+{
+	event_bus bus;
+
+	CHECK(bus.emit(unregistered_event{ 1 }) == nullptr);
+	CHECK(bus.find<unregistered_event>() == nullptr);
+
+	CHECK(bus.queue<hit>() != nullptr);
+	CHECK(bus.find<hit>() == bus.queue<hit>());
+
+	std::thread producers[4];
+
+	for (std::thread& producer : producers)
+	{
+		producer = std::thread([&bus]
+		{
+			for (int idx = 0; idx < 100; ++idx)
+			{
+				bus.emit(hit{ 1 });
+			}
+		});
+	}
+
+	for (std::thread& producer : producers)
+	{
+		producer.join();
+	}
+
+	CHECK(bus.swap());
+	CHECK(bus.read<hit>().size() == 400);
+	CHECK(bus.read<unregistered_event>().empty());
+}
@@ -0,0 +1,78 @@
+#include "test.h"
+
+#include "ecs/ecs.h"
+
+using namespace ecs;
+
+namespace
+{
+
+struct dormant_value
+{
+	int value = 0;
+};
+
+struct dormant_component final : abstract_component<dormant_value>
+{
+};
+
+} // namespace
+
+TEST(wake_ignores_stale_copies_in_blocks)
+{
+	component_locator world;
+	hibernation_store store;
+
+	CHECK(store.register_component<dormant_component>());
+
+	dormant_component* pool = world.add<dormant_component>();
+	entity_id ids[10];
+
+	for (int idx = 0; idx < 10; ++idx)
+	{
+		ids[idx] = entity_id(idx + 1);
+		pool->set(ids[idx], dormant_value{ idx + 1 });
+	}
+
+	CHECK(store.hibernate(world, ids, 10) == 10);
+
+	entity_id one = 1;
+
+	CHECK(store.wake(world, &one, 1) == 1);
+	pool->set(one, dormant_value{ 100 });
+	CHECK(store.hibernate(world, &one, 1) == 1);
+
+	entity_id two_and_one[2] = { 2, 1 };
+
+	CHECK(store.wake(world, two_and_one, 2) == 2);
+	CHECK(pool->get(1)->value == 100);
+	CHECK(pool->get(2)->value == 2);
+	CHECK(store.size() == 8);
+
+	CHECK(store.wake(world, ids, 10) == 8);
+	CHECK(store.size() == 0);
+	CHECK(pool->size() == 10);
+}
+
+TEST(rejected_wake_stays_dormant)
+{
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		component_locator world;
+		hibernation_store store;
+
+		CHECK(store.register_component<dormant_component>());
+
+		dormant_component* pool = world.add<dormant_component>();
+		entity_id old = make_entity_id(7, 0);
+
+		pool->set(old, dormant_value{ 1 });
+		CHECK(store.hibernate(world, &old, 1) == 1);
+
+		pool->set(make_entity_id(7, 1), dormant_value{ 2 });
+
+		CHECK(store.wake(world, &old, 1) == 0);
+		CHECK(store.hibernating(old));
+		CHECK(pool->get(make_entity_id(7, 1))->value == 2);
+	}
+}
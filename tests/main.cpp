@@ -0,0 +1,19 @@
+#include "test.h"
+
+int main()
+{
+	int count = 0;
+
+	for (ecs_tests::test_case* test = ecs_tests::first_test; test; test = test->next)
+	{
+		int before = ecs_tests::failures;
+
+		test->run();
+		++count;
+
+		std::printf("%s %s\n", ecs_tests::failures == before ? "ok  " : "FAIL", test->name);
+	}
+
+	std::printf("%d tests, %d failed checks\n", count, ecs_tests::failures);
+	return ecs_tests::failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,37 @@
+group "tests"
+
+project "tests"
+	location  "build/tests"
+
+	kind "ConsoleApp"
+	language "C++"
+	cppdialect "C++20"
+
+	targetdir "bin/%{cfg.system}/%{cfg.buildcfg}/output"
+	objdir    "bin/%{cfg.system}/%{cfg.buildcfg}/intermediate"
+
+	enablepch "Off"
+
+	includedirs { "../src/include" }
+	links { "ecs" }
+
+	files {
+		"**.cpp",
+		"**.h"
+	}
+
+	filter "system:linux"
+		links { "pthread" }
+
+	filter "configurations:debug"
+		defines { "_DEBUG" }
+		symbols "On"
+
+	filter "configurations:release"
+		defines { "NDEBUG" }
+		optimize "Speed"
+		symbols "On"
+
+	filter {}
+
+group ""
@@ -0,0 +1,74 @@
+#include "test.h"
+
+#include "ecs/ecs.h"
+
+#include <cstring>
+
+using namespace ecs;
+
+namespace
+{
+
+struct static_value
+{
+	int value = 0;
+};
+
+struct static_component final : abstract_component<static_value>
+{
+};
+
+} // namespace
+
+TEST(runtime_restore_requires_same_layout)
+{
+	component_field float_fields[] = { { "x", field_type::float32, 0, 1 }, { "y", field_type::float32, 4, 1 } };
+	component_field int_fields[] = { { "x", field_type::int32, 0, 1 }, { "y", field_type::float32, 4, 1 } };
+
+	runtime_component source(component_descriptor{ "runtime_point", 8, 4, float_fields, 2 });
+	runtime_component other(component_descriptor{ "runtime_point", 8, 4, int_fields, 2 });
+	runtime_component same(component_descriptor{ "runtime_point", 8, 4, float_fields, 2 });
+
+	for (uint32_t idx = 0; idx < 100; ++idx)
+	{
+		float value[2] = { float(idx), 1.0f };
+		source.set(idx, value);
+	}
+
+	CHECK(!other.restore_from(source));
+	CHECK(same.restore_from(source));
+	CHECK(same.size() == 100);
+	CHECK(*static_cast<const float*>(same.get(42)) == 42.0f);
+}
+
+TEST(runtime_index_resolves_once)
+{
+	component_locator world;
+	runtime_component* pool = world.add(component_descriptor{ "runtime_indexed", 4, 4, nullptr, 0 });
+
+	component_locator::component_index idx = component_locator::runtime_index("runtime_indexed");
+
+	CHECK(pool != nullptr);
+	CHECK(idx != component_locator::INVALID_COMPONENT_INDEX);
+	CHECK(world.get(idx) == pool);
+	CHECK(world.get("runtime_indexed") == pool);
+	CHECK(component_locator::runtime_index("runtime_unknown") == component_locator::INVALID_COMPONENT_INDEX);
+
+	world.remove("runtime_indexed");
+	CHECK(world.get(idx) == nullptr);
+}
+
+TEST(runtime_get_ignores_static_slots)
+{
+	component_locator world;
+
+	world.add<static_component>();
+	runtime_component* pool = world.add(component_descriptor{ "runtime_beside_static", 4, 4, nullptr, 0 });
+
+	component_locator::component_index runtime_idx = component_locator::runtime_index("runtime_beside_static");
+
+	for (component_locator::component_index idx = 0; idx < component_locator::MAX_SIZE; ++idx)
+	{
+		CHECK(world.get(idx) == (idx == runtime_idx ? pool : nullptr));
+	}
+}
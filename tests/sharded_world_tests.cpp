@@ -0,0 +1,66 @@
+#include "test.h"
+
+#include "ecs/ecs.h"
+
+using namespace ecs;
+
+namespace
+{
+
+struct cargo
+{
+	int value = 0;
+};
+
+struct cargo_component final : abstract_component<cargo>
+{
+};
+
+} // namespace
+
+TEST(migration_moves_components)
+{
+	sharded_world world(2);
+
+	CHECK(world.register_component<cargo_component>());
+
+	cargo_component* source = world.shard(0).add<cargo_component>();
+	entity_id ids[10];
+
+	for (int idx = 0; idx < 10; ++idx)
+	{
+		ids[idx] = entity_id(idx);
+		source->set(ids[idx], cargo{ idx });
+	}
+
+	CHECK(world.migrate(0, 1, ids, 10) == 10);
+	CHECK(source->size() == 0);
+
+	world.tick(0.0f);
+
+	cargo_component* target = world.shard(1).get<cargo_component>();
+
+	CHECK(target && target->size() == 10 && target->get(4)->value == 4);
+	CHECK(world.failed() == 0);
+}
+
+TEST(rejected_migration_is_counted)
+{
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		sharded_world world(2);
+
+		CHECK(world.register_component<cargo_component>());
+
+		entity_id old = make_entity_id(3, 0);
+
+		world.shard(0).add<cargo_component>()->set(old, cargo{ 1 });
+		world.shard(1).add<cargo_component>()->set(make_entity_id(3, 1), cargo{ 2 });
+
+		CHECK(world.migrate(0, 1, &old, 1) == 1);
+		world.tick(0.0f);
+
+		CHECK(world.failed() == 1);
+		CHECK(world.shard(1).get<cargo_component>()->get(make_entity_id(3, 1))->value == 2);
+	}
+}
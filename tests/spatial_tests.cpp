@@ -0,0 +1,77 @@
+#include "test.h"
+
+#include "ecs/ecs.h"
+
+#include <cmath>
+#include <limits>
+
+using namespace ecs;
+
+namespace
+{
+
+struct point
+{
+	float x = 0.0f;
+	float y = 0.0f;
+};
+
+struct point_component final : abstract_component<point>
+{
+};
+
+} // namespace
+
+TEST(grid_skips_non_finite_positions)
+{
+	point_component pool;
+
+	for (entity_id id = 1; id <= 100; ++id)
+	{
+		pool.set(id, point{ float(id) * 1e7f, 0.5f });
+	}
+
+	pool.set(200, point{ std::nanf(""), 1.0f });
+	pool.set(201, point{ std::numeric_limits<float>::infinity(), 1.0f });
+
+	spatial_grid<point_component> grid(1.0f);
+
+	grid.bind(&pool);
+
+	CHECK(grid.rebuild());
+	CHECK(grid.size() == 100);
+
+	dynamic_array<entity_id> found;
+
+	grid.query_radius({ 5e7f, 0.5f }, 1.0f, found);
+	CHECK(found.size() == 1 && found[0] == 5);
+}
+
+TEST(bvh_skips_non_finite_positions)
+{
+	point_component pool;
+
+	for (entity_id id = 1; id <= 100; ++id)
+	{
+		pool.set(id, point{ float(id), float(id % 10) });
+	}
+
+	pool.set(200, point{ std::nanf(""), 1.0f });
+	pool.set(201, point{ 50.0f, -std::numeric_limits<float>::infinity() });
+
+	spatial_bvh<point_component> bvh;
+
+	bvh.bind(&pool);
+
+	CHECK(bvh.rebuild());
+	CHECK(bvh.size() == 100);
+
+	dynamic_array<entity_id> found;
+
+	bvh.query_box({ { 0.0f, 0.0f }, { 1000.0f, 10.0f } }, found);
+	CHECK(found.size() == 100);
+
+	found.clear();
+	bvh.query_radius({ 37.0f, 7.0f }, 0.5f, found);
+	CHECK(found.size() == 1 && found[0] == 37);
+}
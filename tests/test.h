@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal self-registering test cases: TEST(name) defines one, CHECK records a
+// failure and keeps going so a run reports every broken expectation.
+namespace ecs_tests
+{
+
+struct test_case
+{
+	const char* name;
+	void (*run)();
+	test_case* next;
+};
+
+inline test_case* first_test = nullptr;
+inline int failures = 0;
+
+struct registrar
+{
+	explicit registrar(test_case& test) noexcept
+	{
+		test.next = first_test;
+		first_test = &test;
+	}
+};
+
+} // namespace ecs_tests
+
+#define TEST(name) \
+	static void name(); \
+	static ecs_tests::test_case name##_case { #name, &name, nullptr }; \
+	static ecs_tests::registrar name##_registrar(name##_case); \
+	static void name()
+
+#define CHECK(expr) \
+	do \
+	{ \
+		if (!(expr)) \
+		{ \
+			std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #expr); \
+			++ecs_tests::failures; \
+		} \
+	} \
+	while (0)
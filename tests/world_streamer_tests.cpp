@@ -0,0 +1,209 @@
+#include "test.h"
+
+#include "ecs/ecs.h"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+using namespace ecs;
+
+namespace
+{
+
+struct streamed
+{
+	float x = 0.0f;
+	float y = 0.0f;
+};
+
+struct streamed_component final : abstract_component<streamed>
+{
+};
+
+std::string temp_path(const char* name)
+{
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+
+void drain(world_streamer& streamer, component_locator& world)
+{
+	while (streamer.pending())
+	{
+		streamer.commit(world, std::chrono::milliseconds(5));
+		std::this_thread::yield();
+	}
+}
+
+} // namespace
+
+TEST(streamer_round_trip)
+{
+	world_streamer streamer;
+
+	CHECK(streamer.register_component<streamed_component>(1));
+	CHECK(streamer.start());
+
+	component_locator world;
+	streamed_component* pool = world.add<streamed_component>();
+	entity_id ids[10];
+
+	for (int idx = 0; idx < 10; ++idx)
+	{
+		ids[idx] = entity_id(idx + 1);
+		pool->set(ids[idx], streamed{ float(idx), 0.0f });
+	}
+
+	std::string path = temp_path("ecs_streamer_round_trip.bin");
+
+	CHECK(streamer.unload(world, ids, 10, path.c_str()) == 10);
+	CHECK(pool->size() == 0);
+	drain(streamer, world);
+
+	CHECK(streamer.load(path.c_str()));
+	drain(streamer, world);
+
+	CHECK(pool->size() == 10);
+	CHECK(pool->get(3)->x == 2.0f);
+	CHECK(streamer.failed() == 0);
+
+	std::remove(path.c_str());
+}
+
+TEST(streamer_reinserts_failed_writes)
+{
+	world_streamer streamer;
+
+	CHECK(streamer.register_component<streamed_component>(1));
+	CHECK(streamer.start());
+
+	component_locator world;
+	streamed_component* pool = world.add<streamed_component>();
+	entity_id ids[4] = { 1, 2, 3, 4 };
+
+	for (entity_id id : ids)
+	{
+		pool->set(id, streamed{ float(id), 0.0f });
+	}
+
+	CHECK(streamer.unload(world, ids, 4, "/nonexistent_directory/ecs_streamer.bin") == 4);
+	drain(streamer, world);
+
+	CHECK(streamer.failed() == 1);
+	CHECK(pool->size() == 4);
+	CHECK(pool->get(2)->x == 2.0f);
+}
+
+TEST(streamer_rejects_trailing_bytes)
+{
+	world_streamer streamer;
+
+	CHECK(streamer.register_component<streamed_component>(1));
+	CHECK(streamer.start());
+
+	component_locator world;
+	streamed_component* pool = world.add<streamed_component>();
+	entity_id ids[4] = { 1, 2, 3, 4 };
+
+	for (entity_id id : ids)
+	{
+		pool->set(id, streamed{});
+	}
+
+	std::string path = temp_path("ecs_streamer_trailing.bin");
+
+	CHECK(streamer.unload(world, ids, 4, path.c_str()) == 4);
+	drain(streamer, world);
+
+	if (std::FILE* file = std::fopen(path.c_str(), "ab"))
+	{
+		std::fputc(0, file);
+		std::fclose(file);
+	}
+
+	CHECK(streamer.load(path.c_str()));
+	drain(streamer, world);
+
+	CHECK(pool->size() == 0);
+	CHECK(streamer.failed() == 1);
+
+	std::remove(path.c_str());
+}
+
+TEST(streamer_rejects_corrupt_section_count)
+{
+	world_streamer streamer;
+
+	CHECK(streamer.register_component<streamed_component>(1));
+	CHECK(streamer.start());
+
+	component_locator world;
+	streamed_component* pool = world.add<streamed_component>();
+	entity_id ids[4] = { 1, 2, 3, 4 };
+
+	for (entity_id id : ids)
+	{
+		pool->set(id, streamed{});
+	}
+
+	std::string path = temp_path("ecs_streamer_section_count.bin");
+
+	CHECK(streamer.unload(world, ids, 4, path.c_str()) == 4);
+	drain(streamer, world);
+
+	// The section count follows the magic and the version in the file header.
+	if (std::FILE* file = std::fopen(path.c_str(), "r+b"))
+	{
+		const uint32_t section_count = 0xfffffff0u;
+
+		std::fseek(file, 8, SEEK_SET);
+		std::fwrite(&section_count, sizeof(section_count), 1, file);
+		std::fclose(file);
+	}
+
+	CHECK(streamer.load(path.c_str()));
+	drain(streamer, world);
+
+	CHECK(pool->size() == 0);
+	CHECK(streamer.failed() == 1);
+
+	std::remove(path.c_str());
+}
+
+TEST(streamer_counts_rejected_inserts)
+{
+	if constexpr (ENTITY_GENERATION_BITS > 0)
+	{
+		world_streamer streamer;
+
+		CHECK(streamer.register_component<streamed_component>(1));
+		CHECK(streamer.start());
+
+		component_locator world;
+		streamed_component* pool = world.add<streamed_component>();
+		entity_id ids[2] = { make_entity_id(5, 0), make_entity_id(6, 0) };
+
+		pool->set(ids[0], streamed{ 1.0f, 0.0f });
+		pool->set(ids[1], streamed{ 2.0f, 0.0f });
+
+		std::string path = temp_path("ecs_streamer_rejected.bin");
+
+		CHECK(streamer.unload(world, ids, 2, path.c_str()) == 2);
+		drain(streamer, world);
+
+		// Index 5 was reused while the file was out; its stale copy is refused.
+		pool->set(make_entity_id(5, 1), streamed{ 3.0f, 0.0f });
+
+		CHECK(streamer.load(path.c_str()));
+		drain(streamer, world);
+
+		CHECK(pool->size() == 2);
+		CHECK(pool->get(make_entity_id(5, 1))->x == 3.0f);
+		CHECK(pool->get(ids[1])->x == 2.0f);
+		CHECK(streamer.failed() == 1);
+
+		std::remove(path.c_str());
+	}
+}